@@ -8,6 +8,6 @@ public class ClimbingSystem : ModuleRules
 	{
         PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "MotionWarping" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "PhysicsCore", "InputCore", "EnhancedInput", "MotionWarping", "Landscape", "RenderCore", "ProceduralMeshComponent" });
 	}
 }
@@ -94,7 +94,7 @@ void AClimbingSystemCharacter::SetupPlayerInputComponent(UInputComponent* Player
 	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent)) {
 		
 		// Jumping
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &ACharacter::Jump);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &AClimbingSystemCharacter::HandleJumpInput);
 		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
 
 		// Moving
@@ -213,7 +213,7 @@ void AClimbingSystemCharacter::Climbing(const FInputActionValue& Value)
 {
 	if (!CustomMovementComponent) return;
 
-	if (CustomMovementComponent->IsClimbing())
+	if (CustomMovementComponent->IsClimbing() || CustomMovementComponent->IsOnClimbPath() || CustomMovementComponent->IsLedgeHanging())
 	{
 		CustomMovementComponent->ToggleClimbingMode(false);
 	}
@@ -222,3 +222,15 @@ void AClimbingSystemCharacter::Climbing(const FInputActionValue& Value)
 		CustomMovementComponent->ToggleClimbingMode(true);
 	}
 }
+
+void AClimbingSystemCharacter::HandleJumpInput(const FInputActionValue& Value)
+{
+	if (CustomMovementComponent && (CustomMovementComponent->IsClimbing() || CustomMovementComponent->IsAcceptingBufferedClimbInput()))
+	{
+		// 攀爬蒙太奇的输入窗口内同样交给蹬墙跳，由移动组件缓存
+		CustomMovementComponent->WallJump();
+		return;
+	}
+
+	Jump();
+}
@@ -52,6 +52,9 @@ protected:
 
 	/** Called for jumping input */
 	void Climbing(const FInputActionValue& Value);
+
+	/* 跳跃输入：攀爬时蹬墙跳，否则普通跳跃 */
+	void HandleJumpInput(const FInputActionValue& Value);
 			
 	// APawn interface
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
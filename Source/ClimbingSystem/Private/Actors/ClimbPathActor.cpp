@@ -0,0 +1,99 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "Actors/ClimbPathActor.h"
+
+#include "Components/BoxComponent.h"
+#include "Components/SplineComponent.h"
+
+
+AClimbPathActor::AClimbPathActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	ClimbSpline = CreateDefaultSubobject<USplineComponent>(TEXT("ClimbSpline"));
+	SetRootComponent(ClimbSpline);
+
+	EntryVolume = CreateDefaultSubobject<UBoxComponent>(TEXT("EntryVolume"));
+	EntryVolume->SetupAttachment(ClimbSpline);
+	EntryVolume->SetCollisionProfileName(TEXT("Trigger"));
+	EntryVolume->SetCanEverAffectNavigation(false);
+}
+
+void AClimbPathActor::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	// 根据样条点的包围盒调整进入体积，外扩EntryDistance
+	FBox LocalBounds(ForceInit);
+	for (int32 PointIndex = 0; PointIndex < ClimbSpline->GetNumberOfSplinePoints(); PointIndex++)
+	{
+		LocalBounds += ClimbSpline->GetLocationAtSplinePoint(PointIndex, ESplineCoordinateSpace::Local);
+	}
+
+	if (LocalBounds.IsValid)
+	{
+		LocalBounds = LocalBounds.ExpandBy(EntryDistance);
+		EntryVolume->SetRelativeLocation(LocalBounds.GetCenter());
+		EntryVolume->SetBoxExtent(LocalBounds.GetExtent());
+	}
+}
+
+float AClimbPathActor::GetPathLength() const
+{
+	return ClimbSpline->GetSplineLength();
+}
+
+float AClimbPathActor::FindDistanceClosestToWorldLocation(const FVector& WorldLocation) const
+{
+	const float InputKey = ClimbSpline->FindInputKeyClosestToWorldLocation(WorldLocation);
+	return ClimbSpline->GetDistanceAlongSplineAtSplineInputKey(InputKey);
+}
+
+void AClimbPathActor::GetAttachTransformAtDistance(float Distance, FVector& OutLocation, FQuat& OutRotation, FVector& OutSurfaceNormal) const
+{
+	const FVector SplineLocation = ClimbSpline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+	const FVector Direction = ClimbSpline->GetDirectionAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+
+	if (PathType == EClimbPathType::Zipline)
+	{
+		// 滑索：角色挂在样条线下方，面朝路径的水平方向
+		FVector Facing = Direction.GetSafeNormal2D();
+		if (Facing.IsNearlyZero())
+		{
+			Facing = GetActorForwardVector();
+		}
+
+		OutLocation = SplineLocation - FVector::UpVector * ZiplineHangOffset;
+		OutRotation = FRotationMatrix::MakeFromX(Facing).ToQuat();
+		OutSurfaceNormal = -Facing;
+		return;
+	}
+
+	// 梯子、绳索、水管：角色在Actor前向一侧，面朝样条线
+	FVector Facing = FVector::VectorPlaneProject(GetActorForwardVector(), Direction).GetSafeNormal();
+	if (Facing.IsNearlyZero())
+	{
+		Facing = ClimbSpline->GetUpVectorAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+	}
+
+	OutLocation = SplineLocation + Facing * AttachDistance;
+	OutRotation = FRotationMatrix::MakeFromX(-Facing).ToQuat();
+	OutSurfaceNormal = Facing;
+}
+
+FVector AClimbPathActor::GetDirectionAtDistance(float Distance) const
+{
+	return ClimbSpline->GetDirectionAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+}
+
+bool AClimbPathActor::GetExitLocation(bool bAtEnd, FVector& OutExitLocation) const
+{
+	if (bAtEnd ? !bExitAtEnd : !bExitAtStart)
+	{
+		return false;
+	}
+
+	OutExitLocation = GetActorTransform().TransformPosition(bAtEnd ? EndExitOffset : StartExitOffset);
+	return true;
+}
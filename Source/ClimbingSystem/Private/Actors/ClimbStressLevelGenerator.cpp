@@ -0,0 +1,331 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "Actors/ClimbStressLevelGenerator.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "ProceduralMeshComponent.h"
+#include "UObject/ConstructorHelpers.h"
+
+namespace
+{
+	// 区域顺序固定，随机流的种子由区域下标派生
+	enum EClimbStressSection : int32
+	{
+		Section_Walls,
+		Section_Ledges,
+		Section_Vault,
+		Section_Corners,
+		Section_Overhangs,
+		Section_Rocks,
+	};
+
+	int32 MakeSectionSeed(int32 Seed, int32 SectionIndex)
+	{
+		return static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(SectionIndex)));
+	}
+}
+
+AClimbStressLevelGenerator::AClimbStressLevelGenerator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+	SetRootComponent(SceneRoot);
+
+	BlockInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("BlockInstances"));
+	BlockInstances->SetupAttachment(SceneRoot);
+	BlockInstances->SetMobility(EComponentMobility::Static);
+	BlockInstances->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+
+	RockMesh = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("RockMesh"));
+	RockMesh->SetupAttachment(SceneRoot);
+	RockMesh->bUseComplexAsSimpleCollision = true;		// 岩石使用三角形碰撞，才能测到高面数的检测开销
+	RockMesh->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMesh(TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (CubeMesh.Succeeded())
+	{
+		BlockMesh = CubeMesh.Object;
+	}
+}
+
+void AClimbStressLevelGenerator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// 浸泡测试和基准测试从命令行选择世界
+	FParse::Value(FCommandLine::Get(), TEXT("ClimbStressSeed="), Seed);
+	FParse::Value(FCommandLine::Get(), TEXT("ClimbStressScale="), Scale);
+	Scale = FMath::Max(Scale, 1);
+
+	if (bGenerateOnBeginPlay)
+	{
+		Generate();
+	}
+}
+
+void AClimbStressLevelGenerator::Clear()
+{
+	BlockInstances->ClearInstances();
+	RockMesh->ClearAllMeshSections();
+	NumRockTriangles = 0;
+}
+
+void AClimbStressLevelGenerator::Generate()
+{
+	Clear();
+
+	BlockInstances->SetStaticMesh(BlockMesh);
+
+	// 每个区域一个独立的随机流
+	auto GenerateSection = [this](int32 SectionIndex, void (AClimbStressLevelGenerator::*Generator)(FRandomStream&, const FVector&))
+	{
+		FRandomStream RandomStream(MakeSectionSeed(Seed, SectionIndex));
+		(this->*Generator)(RandomStream, GetSectionOrigin(SectionIndex));
+	};
+
+	GenerateSection(Section_Walls, &AClimbStressLevelGenerator::GenerateWallGrid);
+	GenerateSection(Section_Ledges, &AClimbStressLevelGenerator::GenerateLedgeLadders);
+	GenerateSection(Section_Vault, &AClimbStressLevelGenerator::GenerateVaultBlocks);
+	GenerateSection(Section_Corners, &AClimbStressLevelGenerator::GenerateCorners);
+	GenerateSection(Section_Overhangs, &AClimbStressLevelGenerator::GenerateOverhangs);
+	GenerateSection(Section_Rocks, &AClimbStressLevelGenerator::GenerateRocks);
+
+	UE_LOG(LogTemp, Display, TEXT("%s"), *DescribeGeneratedWorld());
+}
+
+FString AClimbStressLevelGenerator::DescribeGeneratedWorld() const
+{
+	return FString::Printf(TEXT("Climb stress world: seed %d, scale %d, %d blocks, %d rocks, %d rock triangles"),
+		Seed, Scale, BlockInstances->GetInstanceCount(), RockMesh->GetNumSections(), NumRockTriangles);
+}
+
+FVector AClimbStressLevelGenerator::GetSectionOrigin(int32 SectionIndex) const
+{
+	return FVector(SectionIndex * SectionSpacing * Scale, 0.f, 0.f);
+}
+
+void AClimbStressLevelGenerator::AddBlock(const FVector& BottomCenter, const FRotator& Rotation, const FVector& Size)
+{
+	// 立方体网格的原点在中心，边长100厘米
+	const FVector Center = BottomCenter + Rotation.RotateVector(FVector(0.f, 0.f, Size.Z * 0.5f));
+	BlockInstances->AddInstance(FTransform(Rotation, Center, Size / 100.f));
+}
+
+void AClimbStressLevelGenerator::GenerateWallGrid(FRandomStream& RandomStream, const FVector& Origin)
+{
+	// 密集的墙面网格：大量相邻的可攀爬表面，宽相查询会同时返回多个组件
+	const int32 Rows = WallGridSize * Scale;
+	for (int32 Row = 0; Row < Rows; Row++)
+	{
+		for (int32 Column = 0; Column < WallGridSize; Column++)
+		{
+			if (RandomStream.FRand() > 0.7f)
+			{
+				continue;
+			}
+
+			const FVector Location = Origin + FVector(Row * WallGridSpacing, Column * WallGridSpacing, 0.f);
+			const FRotator Rotation(0.f, RandomStream.FRandBool() ? 0.f : 90.f, 0.f);
+			const FVector Size(40.f, RandomStream.FRandRange(250.f, WallGridSpacing - 10.f), RandomStream.FRandRange(300.f, 900.f));
+			AddBlock(Location, Rotation, Size);
+		}
+	}
+}
+
+void AClimbStressLevelGenerator::GenerateLedgeLadders(FRandomStream& RandomStream, const FVector& Origin)
+{
+	// 一面高墙加上一串向外突出的边缘，覆盖挂边、边缘横移和段间衔接
+	const int32 NumLadders = LedgeLadderCount * Scale;
+	for (int32 LadderIndex = 0; LadderIndex < NumLadders; LadderIndex++)
+	{
+		const FVector LadderOrigin = Origin + FVector((LadderIndex % 4) * 900.f, (LadderIndex / 4) * 900.f, 0.f);
+		const FRotator Rotation(0.f, RandomStream.FRandRange(0.f, 360.f), 0.f);
+
+		float Height = 0.f;
+		for (int32 LedgeIndex = 0; LedgeIndex < LedgesPerLadder; LedgeIndex++)
+		{
+			Height += RandomStream.FRandRange(120.f, 180.f);
+
+			const float LedgeWidth = RandomStream.FRandRange(80.f, 300.f);
+			const float LateralOffset = RandomStream.FRandRange(-150.f, 150.f);
+			const FVector LedgeLocation = LadderOrigin + Rotation.RotateVector(FVector(-32.f, LateralOffset, Height));
+			AddBlock(LedgeLocation, Rotation, FVector(25.f, LedgeWidth, 15.f));
+		}
+
+		AddBlock(LadderOrigin, Rotation, FVector(40.f, 500.f, Height + 200.f));
+	}
+}
+
+void AClimbStressLevelGenerator::GenerateVaultBlocks(FRandomStream& RandomStream, const FVector& Origin)
+{
+	// 低矮方块场：翻越检测在每个方块前都会命中起点
+	const int32 NumBlocks = VaultBlockCount * Scale;
+	const float FieldSize = FMath::Sqrt(static_cast<float>(NumBlocks)) * 400.f;
+	for (int32 BlockIndex = 0; BlockIndex < NumBlocks; BlockIndex++)
+	{
+		const FVector Location = Origin + FVector(RandomStream.FRandRange(0.f, FieldSize), RandomStream.FRandRange(0.f, FieldSize), 0.f);
+		const FRotator Rotation(0.f, RandomStream.FRandRange(0.f, 360.f), 0.f);
+		const FVector Size(RandomStream.FRandRange(40.f, 120.f), RandomStream.FRandRange(80.f, 300.f), RandomStream.FRandRange(60.f, 110.f));
+		AddBlock(Location, Rotation, Size);
+	}
+}
+
+void AClimbStressLevelGenerator::GenerateCorners(FRandomStream& RandomStream, const FVector& Origin)
+{
+	// 两面墙在一端相接，夹角随机：外侧是外拐角，内侧是内拐角
+	const int32 NumCorners = CornerCount * Scale;
+	for (int32 CornerIndex = 0; CornerIndex < NumCorners; CornerIndex++)
+	{
+		const FVector CornerLocation = Origin + FVector((CornerIndex % 6) * 1000.f, (CornerIndex / 6) * 1000.f, 0.f);
+		const float BaseYaw = RandomStream.FRandRange(0.f, 360.f);
+		const float CornerAngle = RandomStream.FRandRange(60.f, 150.f);
+		const float Height = RandomStream.FRandRange(400.f, 900.f);
+		const float LengthA = RandomStream.FRandRange(300.f, 600.f);
+		const float LengthB = RandomStream.FRandRange(300.f, 600.f);
+
+		const FRotator RotationA(0.f, BaseYaw, 0.f);
+		const FRotator RotationB(0.f, BaseYaw + CornerAngle, 0.f);
+
+		// 墙沿本地 Y 方向延伸，拐角点在两面墙的一端
+		AddBlock(CornerLocation + RotationA.RotateVector(FVector(0.f, LengthA * 0.5f, 0.f)), RotationA, FVector(40.f, LengthA, Height));
+		AddBlock(CornerLocation + RotationB.RotateVector(FVector(0.f, -LengthB * 0.5f, 0.f)), RotationB, FVector(40.f, LengthB, Height));
+	}
+}
+
+void AClimbStressLevelGenerator::GenerateOverhangs(FRandomStream& RandomStream, const FVector& Origin)
+{
+	// 竖直墙上方接一块向外倾斜的面板
+	const int32 NumOverhangs = OverhangCount * Scale;
+	for (int32 OverhangIndex = 0; OverhangIndex < NumOverhangs; OverhangIndex++)
+	{
+		const FVector Location = Origin + FVector((OverhangIndex % 4) * 1200.f, (OverhangIndex / 4) * 1200.f, 0.f);
+		const float Yaw = RandomStream.FRandRange(0.f, 360.f);
+		const float BaseHeight = RandomStream.FRandRange(300.f, 500.f);
+		const float PanelHeight = RandomStream.FRandRange(200.f, 400.f);
+		const float Tilt = RandomStream.FRandRange(10.f, 35.f);
+		const float Width = RandomStream.FRandRange(300.f, 600.f);
+
+		const FRotator BaseRotation(0.f, Yaw, 0.f);
+		AddBlock(Location, BaseRotation, FVector(40.f, Width, BaseHeight));
+
+		// 绕墙的 Y 轴向攀爬一侧（-X）倾斜
+		const FRotator PanelRotation = (FQuat(BaseRotation) * FQuat(FRotator(-Tilt, 0.f, 0.f))).Rotator();
+		AddBlock(Location + FVector(0.f, 0.f, BaseHeight), PanelRotation, FVector(40.f, Width, PanelHeight));
+	}
+}
+
+void AClimbStressLevelGenerator::GenerateRocks(FRandomStream& RandomStream, const FVector& Origin)
+{
+	const int32 NumRocks = RockCount * Scale;
+	for (int32 RockIndex = 0; RockIndex < NumRocks; RockIndex++)
+	{
+		const float Radius = RandomStream.FRandRange(300.f, 800.f);
+		const FVector Center = Origin + FVector((RockIndex % 3) * 2000.f, (RockIndex / 3) * 2000.f, Radius * 0.6f);
+		BuildRockMesh(RandomStream, RockIndex, Center, Radius);
+	}
+}
+
+void AClimbStressLevelGenerator::BuildRockMesh(FRandomStream& RandomStream, int32 SectionIndex, const FVector& Center, float Radius)
+{
+	// 二十面体
+	const float Phi = (1.f + FMath::Sqrt(5.f)) * 0.5f;
+	TArray<FVector> Vertices = {
+		FVector(-1, Phi, 0), FVector(1, Phi, 0), FVector(-1, -Phi, 0), FVector(1, -Phi, 0),
+		FVector(0, -1, Phi), FVector(0, 1, Phi), FVector(0, -1, -Phi), FVector(0, 1, -Phi),
+		FVector(Phi, 0, -1), FVector(Phi, 0, 1), FVector(-Phi, 0, -1), FVector(-Phi, 0, 1)
+	};
+	for (FVector& Vertex : Vertices)
+	{
+		Vertex.Normalize();
+	}
+
+	TArray<int32> Triangles = {
+		0, 11, 5,	0, 5, 1,	0, 1, 7,	0, 7, 10,	0, 10, 11,
+		1, 5, 9,	5, 11, 4,	11, 10, 2,	10, 7, 6,	7, 1, 8,
+		3, 9, 4,	3, 4, 2,	3, 2, 6,	3, 6, 8,	3, 8, 9,
+		4, 9, 5,	2, 4, 11,	6, 2, 10,	8, 6, 7,	9, 8, 1
+	};
+
+	// 逐级细分，共享边的中点只生成一次
+	for (int32 Level = 0; Level < RockSubdivisions; Level++)
+	{
+		TMap<uint64, int32> MidpointCache;
+		auto GetMidpoint = [&Vertices, &MidpointCache](int32 A, int32 B)
+		{
+			const uint64 Key = (static_cast<uint64>(FMath::Min(A, B)) << 32) | static_cast<uint32>(FMath::Max(A, B));
+			if (const int32* Existing = MidpointCache.Find(Key))
+			{
+				return *Existing;
+			}
+			const int32 Index = Vertices.Add(((Vertices[A] + Vertices[B]) * 0.5f).GetSafeNormal());
+			MidpointCache.Add(Key, Index);
+			return Index;
+		};
+
+		TArray<int32> Subdivided;
+		Subdivided.Reserve(Triangles.Num() * 4);
+		for (int32 Index = 0; Index < Triangles.Num(); Index += 3)
+		{
+			const int32 A = Triangles[Index];
+			const int32 B = Triangles[Index + 1];
+			const int32 C = Triangles[Index + 2];
+			const int32 AB = GetMidpoint(A, B);
+			const int32 BC = GetMidpoint(B, C);
+			const int32 CA = GetMidpoint(C, A);
+			Subdivided.Append({ A, AB, CA,	B, BC, AB,	C, CA, BC,	AB, BC, CA });
+		}
+		Triangles = MoveTemp(Subdivided);
+	}
+
+	// 噪声偏移来自随机流，位移只依赖种子
+	const FVector NoiseOffset(RandomStream.FRandRange(-1000.f, 1000.f), RandomStream.FRandRange(-1000.f, 1000.f), RandomStream.FRandRange(-1000.f, 1000.f));
+	const FVector Squash(RandomStream.FRandRange(0.8f, 1.3f), RandomStream.FRandRange(0.8f, 1.3f), RandomStream.FRandRange(0.6f, 1.1f));
+	for (FVector& Vertex : Vertices)
+	{
+		const float Noise = FMath::PerlinNoise3D(Vertex * 2.5f + NoiseOffset) * 0.25f + FMath::PerlinNoise3D(Vertex * 9.f + NoiseOffset) * 0.06f;
+		Vertex = Center - GetActorLocation() + Vertex * Squash * Radius * (1.f + Noise);
+	}
+
+	// 法线和 UKismetProceduralMeshLibrary::CalculateTangentsForMesh 的约定一致，朝内的三角形翻转索引顺序
+	const FVector LocalCenter = Center - GetActorLocation();
+	for (int32 Index = 0; Index < Triangles.Num(); Index += 3)
+	{
+		const FVector& A = Vertices[Triangles[Index]];
+		const FVector& B = Vertices[Triangles[Index + 1]];
+		const FVector& C = Vertices[Triangles[Index + 2]];
+		if (FVector::DotProduct(FVector::CrossProduct(C - A, B - A), (A + B + C) / 3.f - LocalCenter) < 0.f)
+		{
+			Swap(Triangles[Index + 1], Triangles[Index + 2]);
+		}
+	}
+
+	TArray<FVector> Normals;
+	Normals.SetNumZeroed(Vertices.Num());
+	for (int32 Index = 0; Index < Triangles.Num(); Index += 3)
+	{
+		const FVector& A = Vertices[Triangles[Index]];
+		const FVector& B = Vertices[Triangles[Index + 1]];
+		const FVector& C = Vertices[Triangles[Index + 2]];
+		const FVector FaceNormal = FVector::CrossProduct(C - A, B - A);
+		Normals[Triangles[Index]] += FaceNormal;
+		Normals[Triangles[Index + 1]] += FaceNormal;
+		Normals[Triangles[Index + 2]] += FaceNormal;
+	}
+	for (FVector& Normal : Normals)
+	{
+		Normal.Normalize();
+	}
+
+	RockMesh->CreateMeshSection_LinearColor(SectionIndex, Vertices, Triangles, Normals, TArray<FVector2D>(), TArray<FLinearColor>(), TArray<FProcMeshTangent>(), true);
+	if (RockMaterial)
+	{
+		RockMesh->SetMaterial(SectionIndex, RockMaterial);
+	}
+
+	NumRockTriangles += Triangles.Num() / 3;
+}
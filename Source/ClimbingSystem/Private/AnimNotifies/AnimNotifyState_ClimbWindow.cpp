@@ -0,0 +1,42 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "AnimNotifies/AnimNotifyState_ClimbWindow.h"
+
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "CustomComponents/CustomMovementComponent.h"
+
+namespace
+{
+	UCustomMovementComponent* FindClimbMovementComponent(const USkeletalMeshComponent* MeshComp)
+	{
+		const AActor* Owner = MeshComp ? MeshComp->GetOwner() : nullptr;
+		return Owner ? Owner->FindComponentByClass<UCustomMovementComponent>() : nullptr;
+	}
+}
+
+void UAnimNotifyState_ClimbWindow::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyBegin(MeshComp, Animation, TotalDuration, EventReference);
+
+	if (UCustomMovementComponent* CustomMovementComponent = FindClimbMovementComponent(MeshComp))
+	{
+		CustomMovementComponent->NotifyClimbWindowBegin(WindowType, Cast<UAnimMontage>(Animation));
+	}
+}
+
+void UAnimNotifyState_ClimbWindow::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyEnd(MeshComp, Animation, EventReference);
+
+	if (UCustomMovementComponent* CustomMovementComponent = FindClimbMovementComponent(MeshComp))
+	{
+		CustomMovementComponent->NotifyClimbWindowEnd(WindowType);
+	}
+}
+
+FString UAnimNotifyState_ClimbWindow::GetNotifyName_Implementation() const
+{
+	return FString::Printf(TEXT("Climb Window: %s"), *UEnum::GetDisplayValueAsText(WindowType).ToString());
+}
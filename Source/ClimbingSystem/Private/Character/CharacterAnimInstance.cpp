@@ -7,6 +7,7 @@
 #include "ClimbingSystem/DebugHelper.h"
 #include "CustomComponents/CustomMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Engine/World.h"
 
 
 void UCharacterAnimInstance::NativeInitializeAnimation()
@@ -32,6 +33,22 @@ void UCharacterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 	GetShouldMove();
 	GetIsClimbing();
 	GetClimbVelocity();
+
+	if (bEnableClimbLimbIK)
+	{
+		GatherClimbLimbIKInputs();
+		UpdateClimbLimbRefinement();
+	}
+}
+
+void UCharacterAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	if (bEnableClimbLimbIK)
+	{
+		UpdateClimbLimbIKTargets(DeltaSeconds);
+	}
 }
 
 void UCharacterAnimInstance::GetGroundSpeed()
@@ -109,3 +126,238 @@ void UCharacterAnimInstance::GetClimbVelocity()
 		ClimbVelocity = FVector::ZeroVector;
 	}
 }
+
+void UCharacterAnimInstance::GatherClimbLimbIKInputs()
+{
+	ClimbLimbTime = GetWorld()->GetTimeSeconds();
+
+	FClimbLimbIKInputs& Inputs = ClimbLimbIKInputs;
+
+	// 蒙太奇（上墙、冲刺、登顶）自己摆放四肢，不做 IK
+	Inputs.bActive = CustomMovementComponent->IsClimbing() && !IsAnyMontagePlaying()
+		&& !CustomMovementComponent->GetCurrentClimbableSurfaceNormal().IsNearlyZero();
+	if (!Inputs.bActive)
+	{
+		Inputs.NumSurfaceSamples = 0;
+		return;
+	}
+
+	Inputs.ActorTransform = ClimbingSystemCharacter->GetActorTransform();
+	Inputs.SurfaceLocation = CustomMovementComponent->GetCurrentClimbableSurfaceLocation();
+	Inputs.SurfaceNormal = CustomMovementComponent->GetCurrentClimbableSurfaceNormal();
+
+	const TArray<FHitResult>& SurfaceHits = CustomMovementComponent->GetClimbableSurfaceTraceHits();
+	Inputs.NumSurfaceSamples = FMath::Min(SurfaceHits.Num(), FClimbLimbIKInputs::MaxSurfaceSamples);
+	for (int32 Index = 0; Index < Inputs.NumSurfaceSamples; Index++)
+	{
+		Inputs.SurfacePoints[Index] = SurfaceHits[Index].ImpactPoint;
+		Inputs.SurfaceNormals[Index] = SurfaceHits[Index].ImpactNormal;
+	}
+}
+
+void UCharacterAnimInstance::UpdateClimbLimbRefinement()
+{
+	UWorld* World = GetWorld();
+
+	// 收取上一次发起的检测，异步检测和其他检测一起在下一帧之前批量完成
+	if (ClimbLimbRefineTrace.IsValid())
+	{
+		FTraceDatum TraceDatum;
+		if (!World->QueryTraceData(ClimbLimbRefineTrace, TraceDatum))
+		{
+			if (!World->IsTraceHandleValid(ClimbLimbRefineTrace, false))
+			{
+				// 动画跳过了更新，结果已经被丢弃
+				ClimbLimbRefineTrace = FTraceHandle();
+				ClimbLimbRefineTraceLimb = INDEX_NONE;
+			}
+			return;
+		}
+
+		// 异步检测不经过 CS_ClimbTrace，在这里计入检测次数和 Visual Logger
+		const CS_ClimbTrace::FTraceContext& TraceContext = CustomMovementComponent->GetClimbTraceContext();
+		TraceContext.NumTraces++;
+		{
+			CLIMB_VLOG_PROBE_SCOPE("LimbRefine");
+			CLIMB_VLOG_LINE_TRACE(TraceContext.LogOwner, TraceDatum.Start, TraceDatum.End, TraceDatum.OutHits.IsEmpty() ? FHitResult() : TraceDatum.OutHits[0]);
+		}
+
+		FClimbLimbRefinement& Refinement = ClimbLimbRefinements[ClimbLimbRefineTraceLimb];
+		Refinement.bValid = false;
+		if (!TraceDatum.OutHits.IsEmpty() && TraceDatum.OutHits[0].bBlockingHit && !TraceDatum.OutHits[0].bStartPenetrating)
+		{
+			const FHitResult& Hit = TraceDatum.OutHits[0];
+			const FVector& PlanePoint = ClimbLimbPlanePoints[ClimbLimbRefineTraceLimb];
+			const FVector& PlaneNormal = ClimbLimbPlaneNormals[ClimbLimbRefineTraceLimb];
+
+			Refinement.bValid = true;
+			Refinement.Depth = FVector::DotProduct(Hit.ImpactPoint - PlanePoint, PlaneNormal);
+			Refinement.Normal = Hit.ImpactNormal;
+			Refinement.Time = ClimbLimbTime;
+		}
+
+		ClimbLimbRefineTrace = FTraceHandle();
+		ClimbLimbRefineTraceLimb = INDEX_NONE;
+	}
+
+	if (!ClimbLimbIKInputs.bActive)
+	{
+		for (FClimbLimbRefinement& Refinement : ClimbLimbRefinements)
+		{
+			Refinement.bValid = false;
+		}
+		return;
+	}
+
+	if (ClimbLimbTime - LastClimbLimbRefineTime < ClimbLimbRefineInterval)
+	{
+		return;
+	}
+
+	// 从上次的下一个肢体开始轮询，只检测命中覆盖不到且没有有效结果的肢体
+	for (int32 Offset = 0; Offset < NumClimbLimbs; Offset++)
+	{
+		const int32 Limb = (NextClimbLimbToRefine + Offset) % NumClimbLimbs;
+		const FClimbLimbRefinement& Refinement = ClimbLimbRefinements[Limb];
+		const bool bRefinementValid = Refinement.bValid && ClimbLimbTime - Refinement.Time < ClimbLimbRefineLifetime;
+		if (!bClimbLimbNeedsRefine[Limb] || bRefinementValid)
+		{
+			continue;
+		}
+
+		const CS_ClimbTrace::FTraceContext& TraceContext = CustomMovementComponent->GetClimbTraceContext();
+		const FVector Start = ClimbLimbPlanePoints[Limb] + ClimbLimbPlaneNormals[Limb] * ClimbLimbRefineDistance;
+		const FVector End = ClimbLimbPlanePoints[Limb] - ClimbLimbPlaneNormals[Limb] * ClimbLimbRefineDistance;
+
+		if (TraceContext.UsesTraceChannel())
+		{
+			ClimbLimbRefineTrace = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, TraceContext.TraceChannel, TraceContext.QueryParams);
+		}
+		else
+		{
+			ClimbLimbRefineTrace = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Start, End, TraceContext.ObjectParams, TraceContext.QueryParams);
+		}
+
+		ClimbLimbRefineTraceLimb = Limb;
+		NextClimbLimbToRefine = (Limb + 1) % NumClimbLimbs;
+		LastClimbLimbRefineTime = ClimbLimbTime;
+		break;
+	}
+}
+
+void UCharacterAnimInstance::UpdateClimbLimbIKTargets(float DeltaSeconds)
+{
+	const FClimbLimbIKInputs& Inputs = ClimbLimbIKInputs;
+
+	for (int32 Limb = 0; Limb < NumClimbLimbs; Limb++)
+	{
+		FClimbLimbIKTarget& Target = GetClimbLimbIKTarget(static_cast<EClimbLimb>(Limb));
+		Target.Alpha = FMath::FInterpTo(Target.Alpha, Inputs.bActive ? 1.f : 0.f, DeltaSeconds, ClimbLimbAlphaInterpSpeed);
+
+		if (!Inputs.bActive)
+		{
+			bClimbLimbNeedsRefine[Limb] = false;
+			continue;
+		}
+
+		// 肢体的基准位置投影到附近命中拟合的平面上
+		const FVector RestLocation = Inputs.ActorTransform.TransformPosition(GetClimbLimbRestOffset(static_cast<EClimbLimb>(Limb)));
+
+		FVector PlanePoint;
+		FVector PlaneNormal;
+		float CoverageDistance;
+		FitClimbSurfaceAt(RestLocation, PlanePoint, PlaneNormal, CoverageDistance);
+
+		const FVector ProjectedLocation = RestLocation - PlaneNormal * FVector::DotProduct(RestLocation - PlanePoint, PlaneNormal);
+		ClimbLimbPlanePoints[Limb] = ProjectedLocation;
+		ClimbLimbPlaneNormals[Limb] = PlaneNormal;
+		bClimbLimbNeedsRefine[Limb] = CoverageDistance > ClimbLimbSampleCoverage;
+
+		// 有效的细化结果修正平面和真实表面之间的偏差
+		FVector SurfaceLocation = ProjectedLocation;
+		FVector SurfaceNormal = PlaneNormal;
+		const FClimbLimbRefinement& Refinement = ClimbLimbRefinements[Limb];
+		if (Refinement.bValid && ClimbLimbTime - Refinement.Time < ClimbLimbRefineLifetime)
+		{
+			SurfaceLocation += PlaneNormal * Refinement.Depth;
+			SurfaceNormal = Refinement.Normal;
+		}
+
+		// 在角色空间中插值，基座移动时目标不会拖在后面
+		const FVector TargetLocation = SurfaceLocation + SurfaceNormal * ClimbLimbSurfaceOffset;
+		const FVector LocalTarget = Inputs.ActorTransform.InverseTransformPosition(TargetLocation);
+		ClimbLimbLocalTargets[Limb] = Target.Alpha > KINDA_SMALL_NUMBER
+			? FMath::VInterpTo(ClimbLimbLocalTargets[Limb], LocalTarget, DeltaSeconds, ClimbLimbInterpSpeed)
+			: LocalTarget;
+
+		Target.Location = Inputs.ActorTransform.TransformPosition(ClimbLimbLocalTargets[Limb]);
+		Target.Normal = SurfaceNormal;
+	}
+}
+
+void UCharacterAnimInstance::FitClimbSurfaceAt(const FVector& Location, FVector& OutPoint, FVector& OutNormal, float& OutCoverageDistance) const
+{
+	const FClimbLimbIKInputs& Inputs = ClimbLimbIKInputs;
+
+	OutPoint = Inputs.SurfaceLocation;
+	OutNormal = Inputs.SurfaceNormal;
+	OutCoverageDistance = UE_BIG_NUMBER;
+
+	if (Inputs.NumSurfaceSamples == 0)
+	{
+		return;
+	}
+
+	// 按到肢体的距离反比加权，离肢体近的命中决定局部平面
+	FVector WeightedPoint = FVector::ZeroVector;
+	FVector WeightedNormal = FVector::ZeroVector;
+	float TotalWeight = 0.f;
+	for (int32 Index = 0; Index < Inputs.NumSurfaceSamples; Index++)
+	{
+		const float DistanceSquared = FVector::DistSquared(Location, Inputs.SurfacePoints[Index]);
+		const float Weight = 1.f / (DistanceSquared + 1.f);
+		WeightedPoint += Inputs.SurfacePoints[Index] * Weight;
+		WeightedNormal += Inputs.SurfaceNormals[Index] * Weight;
+		TotalWeight += Weight;
+		OutCoverageDistance = FMath::Min(OutCoverageDistance, FMath::Sqrt(DistanceSquared));
+	}
+
+	OutPoint = WeightedPoint / TotalWeight;
+	OutNormal = WeightedNormal.GetSafeNormal();
+	if (OutNormal.IsNearlyZero())
+	{
+		OutNormal = Inputs.SurfaceNormal;
+	}
+}
+
+FVector UCharacterAnimInstance::GetClimbLimbRestOffset(EClimbLimb Limb) const
+{
+	switch (Limb)
+	{
+	case EClimbLimb::HandLeft:
+		return FVector(ClimbHandRestOffset.X, -ClimbHandRestOffset.Y, ClimbHandRestOffset.Z);
+	case EClimbLimb::HandRight:
+		return ClimbHandRestOffset;
+	case EClimbLimb::FootLeft:
+		return FVector(ClimbFootRestOffset.X, -ClimbFootRestOffset.Y, ClimbFootRestOffset.Z);
+	case EClimbLimb::FootRight:
+	default:
+		return ClimbFootRestOffset;
+	}
+}
+
+FClimbLimbIKTarget& UCharacterAnimInstance::GetClimbLimbIKTarget(EClimbLimb Limb)
+{
+	switch (Limb)
+	{
+	case EClimbLimb::HandLeft:
+		return ClimbHandLeftIK;
+	case EClimbLimb::HandRight:
+		return ClimbHandRightIK;
+	case EClimbLimb::FootLeft:
+		return ClimbFootLeftIK;
+	case EClimbLimb::FootRight:
+	default:
+		return ClimbFootRightIK;
+	}
+}
@@ -0,0 +1,160 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "Commandlets/ClimbTelemetryHeatmapCommandlet.h"
+
+#include "CustomComponents/ClimbTelemetry.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	// 一个热力图格子的累计数据
+	struct FClimbHeatmapCell
+	{
+		int32 Attempts = 0;			// 上墙、冲刺、翻越的尝试次数（成功和失败）
+		int32 Failures = 0;			// 上墙失败、冲刺被拒绝、服务器拒绝
+		int32 EventCounts[static_cast<int32>(EClimbTelemetryEvent::MAX)] = {};
+		int32 Frames = 0;			// 有检测的帧数
+		int64 Traces = 0;			// 检测次数
+		double CostMicroseconds = 0.0;	// 检测总耗时
+	};
+
+	using FClimbHeatmap = TMap<FIntPoint, FClimbHeatmapCell>;
+}
+
+UClimbTelemetryHeatmapCommandlet::UClimbTelemetryHeatmapCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UClimbTelemetryHeatmapCommandlet::Main(const FString& Params)
+{
+	FString InputDirectory = CS_ClimbTelemetry::GetTelemetryDirectory();
+	FString OutputDirectory = InputDirectory / TEXT("Heatmaps");
+	float CellSize = 200.f;
+
+	FParse::Value(*Params, TEXT("Input="), InputDirectory);
+	FParse::Value(*Params, TEXT("Output="), OutputDirectory);
+	FParse::Value(*Params, TEXT("CellSize="), CellSize);
+	CellSize = FMath::Max(CellSize, 1.f);
+
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *(InputDirectory / TEXT("*.cltm")), true, false);
+	if (FileNames.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No climb telemetry files found in %s"), *InputDirectory);
+		return 1;
+	}
+
+	// 同一张地图的所有文件聚合到一张热力图
+	TMap<FString, FClimbHeatmap> Heatmaps;
+	int64 TotalRecords = 0;
+
+	for (const FString& FileName : FileNames)
+	{
+		FString MapName;
+		FClimbHeatmap* Heatmap = nullptr;
+
+		const bool bRead = CS_ClimbTelemetry::ReadFile(InputDirectory / FileName, MapName, [&](const FClimbTelemetryChunk& Chunk)
+		{
+			if (!Heatmap)
+			{
+				Heatmap = &Heatmaps.FindOrAdd(MapName);
+			}
+
+			for (int32 Index = 0; Index < Chunk.Num(); Index++)
+			{
+				// 未知事件（损坏或更新版本的记录）不能生成空的格子
+				const EClimbTelemetryEvent Event = static_cast<EClimbTelemetryEvent>(Chunk.Events[Index]);
+				if (Event >= EClimbTelemetryEvent::MAX)
+				{
+					continue;
+				}
+
+				const FIntPoint Cell(FMath::FloorToInt(Chunk.LocationX[Index] / CellSize), FMath::FloorToInt(Chunk.LocationY[Index] / CellSize));
+				FClimbHeatmapCell& HeatmapCell = Heatmap->FindOrAdd(Cell);
+				HeatmapCell.EventCounts[Chunk.Events[Index]]++;
+
+				switch (Event)
+				{
+				case EClimbTelemetryEvent::FrameCost:
+					HeatmapCell.Frames++;
+					HeatmapCell.Traces += Chunk.NumTraces[Index];
+					HeatmapCell.CostMicroseconds += Chunk.Costs[Index];
+					break;
+				case EClimbTelemetryEvent::ClimbStart:
+				case EClimbTelemetryEvent::Dash:
+				case EClimbTelemetryEvent::Vault:
+					HeatmapCell.Attempts++;
+					break;
+				case EClimbTelemetryEvent::ClimbStartFailed:
+				case EClimbTelemetryEvent::DashRejected:
+				case EClimbTelemetryEvent::MoveRejected:
+				case EClimbTelemetryEvent::GripLost:
+					HeatmapCell.Attempts++;
+					HeatmapCell.Failures++;
+					break;
+				default:
+					break;
+				}
+			}
+
+			TotalRecords += Chunk.Num();
+		});
+
+		if (!bRead)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Skipping unreadable climb telemetry file %s"), *FileName);
+		}
+	}
+
+	for (const TPair<FString, FClimbHeatmap>& Pair : Heatmaps)
+	{
+		// 按检测耗时从高到低输出，最热的格子在最前面
+		TArray<FIntPoint> Cells;
+		Pair.Value.GetKeys(Cells);
+		Cells.Sort([&Pair](const FIntPoint& A, const FIntPoint& B)
+		{
+			return Pair.Value[A].CostMicroseconds > Pair.Value[B].CostMicroseconds;
+		});
+
+		TArray<FString> Lines;
+		Lines.Reserve(Cells.Num() + 1);
+		Lines.Add(TEXT("CellX,CellY,WorldX,WorldY,Attempts,Failures,FailureRate,ClimbStarts,ClimbStartFailures,Dashes,DashRejections,Vaults,TopOuts,MoveRejections,GripLosses,ProbeFrames,Traces,TraceCostMs,AvgFrameCostUs"));
+
+		for (const FIntPoint& Cell : Cells)
+		{
+			const FClimbHeatmapCell& HeatmapCell = Pair.Value[Cell];
+			auto Count = [&HeatmapCell](EClimbTelemetryEvent Event) { return HeatmapCell.EventCounts[static_cast<int32>(Event)]; };
+
+			Lines.Add(FString::Printf(TEXT("%d,%d,%.0f,%.0f,%d,%d,%.3f,%d,%d,%d,%d,%d,%d,%d,%d,%d,%lld,%.3f,%.2f"),
+				Cell.X, Cell.Y, (Cell.X + 0.5f) * CellSize, (Cell.Y + 0.5f) * CellSize,
+				HeatmapCell.Attempts, HeatmapCell.Failures,
+				HeatmapCell.Attempts > 0 ? static_cast<float>(HeatmapCell.Failures) / HeatmapCell.Attempts : 0.f,
+				Count(EClimbTelemetryEvent::ClimbStart), Count(EClimbTelemetryEvent::ClimbStartFailed),
+				Count(EClimbTelemetryEvent::Dash), Count(EClimbTelemetryEvent::DashRejected),
+				Count(EClimbTelemetryEvent::Vault), Count(EClimbTelemetryEvent::TopOut), Count(EClimbTelemetryEvent::MoveRejected), Count(EClimbTelemetryEvent::GripLost),
+				HeatmapCell.Frames, HeatmapCell.Traces, HeatmapCell.CostMicroseconds / 1000.0,
+				HeatmapCell.Frames > 0 ? HeatmapCell.CostMicroseconds / HeatmapCell.Frames : 0.0));
+		}
+
+		const FString OutputPath = OutputDirectory / FString::Printf(TEXT("%s_Heatmap.csv"), *Pair.Key);
+		if (FFileHelper::SaveStringArrayToFile(Lines, *OutputPath))
+		{
+			UE_LOG(LogTemp, Display, TEXT("%s: %d cells written to %s"), *Pair.Key, Cells.Num(), *OutputPath);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Failed to write %s"), *OutputPath);
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Aggregated %lld records from %d files into %d maps"), TotalRecords, FileNames.Num(), Heatmaps.Num());
+	return 0;
+}
@@ -0,0 +1,229 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "CustomComponents/ClimbCollisionProxyComponent.h"
+
+#include "CustomComponents/ClimbCollision.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "StaticMeshResources.h"
+
+UClimbCollisionProxyComponent::UClimbCollisionProxyComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// 距离场和服务器校验缓存只接受静态组件
+	Mobility = EComponentMobility::Static;
+
+	SetCollisionProfileName(CS_ClimbCollision::ProxyProfileName);
+	SetGenerateOverlapEvents(false);
+	SetHiddenInGame(true);
+	CanCharacterStepUpOn = ECB_No;
+	bCanEverAffectNavigation = false;
+}
+
+UBodySetup* UClimbCollisionProxyComponent::GetBodySetup()
+{
+	return ProxyBodySetup;
+}
+
+FBoxSphereBounds UClimbCollisionProxyComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (ProxyBodySetup && ProxyBodySetup->AggGeom.GetElementCount() > 0)
+	{
+		return FBoxSphereBounds(ProxyBodySetup->AggGeom.CalcAABB(LocalToWorld));
+	}
+	return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+}
+
+int32 UClimbCollisionProxyComponent::GetNumProxyElements() const
+{
+	return ProxyBodySetup ? ProxyBodySetup->AggGeom.GetElementCount() : 0;
+}
+
+void UClimbCollisionProxyComponent::OnRegister()
+{
+	// 和父组件的可移动性一致：静态网格下的代理是静态的，移动平台下的代理跟着移动
+	if (const USceneComponent* Parent = GetAttachParent())
+	{
+		Mobility = Parent->Mobility;
+	}
+
+	// 物理状态在 OnRegister 之后创建，这里只需要准备好几何
+	if (!ProxyBodySetup || BuiltFromMesh.Get() != GetSourceMesh())
+	{
+		BuildProxyGeometry();
+	}
+
+	Super::OnRegister();
+}
+
+#if WITH_EDITOR
+void UClimbCollisionProxyComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	RebuildProxy();
+}
+#endif
+
+UStaticMesh* UClimbCollisionProxyComponent::GetSourceMesh() const
+{
+	if (SourceMesh)
+	{
+		return SourceMesh;
+	}
+
+	const UStaticMeshComponent* ParentMesh = Cast<UStaticMeshComponent>(GetAttachParent());
+	return ParentMesh ? ParentMesh->GetStaticMesh() : nullptr;
+}
+
+void UClimbCollisionProxyComponent::RebuildProxy()
+{
+	BuildProxyGeometry();
+
+	if (IsRegistered())
+	{
+		RecreatePhysicsState();
+		UpdateBounds();
+	}
+}
+
+void UClimbCollisionProxyComponent::BuildProxyGeometry()
+{
+	UStaticMesh* Mesh = GetSourceMesh();
+
+	FKAggregateGeom Geometry;
+	if (Mesh)
+	{
+		switch (ProxySource)
+		{
+		case EClimbProxySource::Auto:
+			BuildFromAssetUserData(Mesh, Geometry)
+				|| BuildFromSimpleCollision(Mesh, Geometry)
+				|| BuildFromRenderMeshHull(Mesh, MaxHullVertices, Geometry)
+				|| BuildFromBounds(Mesh, Geometry);
+			break;
+		case EClimbProxySource::AssetUserData:
+			BuildFromAssetUserData(Mesh, Geometry);
+			break;
+		case EClimbProxySource::SimpleCollision:
+			BuildFromSimpleCollision(Mesh, Geometry);
+			break;
+		case EClimbProxySource::RenderMeshHull:
+			BuildFromRenderMeshHull(Mesh, MaxHullVertices, Geometry);
+			break;
+		case EClimbProxySource::Bounds:
+			BuildFromBounds(Mesh, Geometry);
+			break;
+		}
+	}
+
+	if (!ProxyBodySetup)
+	{
+		ProxyBodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
+		ProxyBodySetup->BodySetupGuid = FGuid::NewGuid();
+		ProxyBodySetup->bGenerateMirroredCollision = false;
+		ProxyBodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;	// 攀爬检测只需要简单几何
+	}
+
+	ProxyBodySetup->RemoveSimpleCollision();
+	ProxyBodySetup->AggGeom = MoveTemp(Geometry);
+	ProxyBodySetup->InvalidatePhysicsData();
+	ProxyBodySetup->CreatePhysicsMeshes();
+
+	BuiltFromMesh = Mesh;
+}
+
+bool UClimbCollisionProxyComponent::BuildFromAssetUserData(UStaticMesh* Mesh, FKAggregateGeom& OutGeometry)
+{
+	const UClimbCollisionProxyUserData* UserData = Mesh->GetAssetUserData<UClimbCollisionProxyUserData>();
+	if (!UserData || UserData->ProxyGeometry.GetElementCount() == 0)
+	{
+		return false;
+	}
+
+	OutGeometry = UserData->ProxyGeometry;
+	return true;
+}
+
+bool UClimbCollisionProxyComponent::BuildFromSimpleCollision(const UStaticMesh* Mesh, FKAggregateGeom& OutGeometry)
+{
+	const UBodySetup* MeshBodySetup = Mesh->GetBodySetup();
+	if (!MeshBodySetup || MeshBodySetup->AggGeom.GetElementCount() == 0)
+	{
+		return false;
+	}
+
+	OutGeometry = MeshBodySetup->AggGeom;
+	return true;
+}
+
+bool UClimbCollisionProxyComponent::BuildFromRenderMeshHull(const UStaticMesh* Mesh, int32 MaxHullVertices, FKAggregateGeom& OutGeometry)
+{
+	// 打包后的版本只有开启了 CPU 访问的网格才有顶点数据
+	const FStaticMeshRenderData* RenderData = Mesh->GetRenderData();
+	if (!RenderData || RenderData->LODResources.IsEmpty() || (!WITH_EDITOR && !Mesh->bAllowCPUAccess))
+	{
+		return false;
+	}
+
+	const FPositionVertexBuffer& Positions = RenderData->LODResources.Last().VertexBuffers.PositionVertexBuffer;
+	const int32 NumVertices = Positions.GetNumVertices();
+	if (NumVertices < 4)
+	{
+		return false;
+	}
+
+	// 沿均匀分布的方向取最远的顶点，凸包顶点数不超过方向数
+	TArray<FVector> HullVertices;
+	const int32 NumDirections = FMath::Max(MaxHullVertices, 8);
+	for (int32 DirectionIndex = 0; DirectionIndex < NumDirections; DirectionIndex++)
+	{
+		// 斐波那契球面方向
+		const float Z = 1.f - 2.f * (DirectionIndex + 0.5f) / NumDirections;
+		const float Radius = FMath::Sqrt(1.f - Z * Z);
+		const float Theta = UE_PI * (3.f - FMath::Sqrt(5.f)) * DirectionIndex;
+		const FVector3f Direction(FMath::Cos(Theta) * Radius, FMath::Sin(Theta) * Radius, Z);
+
+		int32 BestIndex = 0;
+		float BestDistance = -UE_BIG_NUMBER;
+		for (int32 VertexIndex = 0; VertexIndex < NumVertices; VertexIndex++)
+		{
+			const float Distance = FVector3f::DotProduct(Positions.VertexPosition(VertexIndex), Direction);
+			if (Distance > BestDistance)
+			{
+				BestDistance = Distance;
+				BestIndex = VertexIndex;
+			}
+		}
+
+		HullVertices.AddUnique(FVector(Positions.VertexPosition(BestIndex)));
+	}
+
+	if (HullVertices.Num() < 4)
+	{
+		return false;
+	}
+
+	FKConvexElem& ConvexElem = OutGeometry.ConvexElems.AddDefaulted_GetRef();
+	ConvexElem.VertexData = MoveTemp(HullVertices);
+	ConvexElem.UpdateElemBox();
+	return true;
+}
+
+bool UClimbCollisionProxyComponent::BuildFromBounds(const UStaticMesh* Mesh, FKAggregateGeom& OutGeometry)
+{
+	const FBox Bounds = Mesh->GetBoundingBox();
+	if (!Bounds.IsValid)
+	{
+		return false;
+	}
+
+	const FVector Size = Bounds.GetSize();
+	FKBoxElem& BoxElem = OutGeometry.BoxElems.Emplace_GetRef(Size.X, Size.Y, Size.Z);
+	BoxElem.Center = Bounds.GetCenter();
+	return true;
+}
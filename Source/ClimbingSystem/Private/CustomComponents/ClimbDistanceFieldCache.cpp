@@ -0,0 +1,337 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "CustomComponents/ClimbDistanceFieldCache.h"
+
+#include "CustomComponents/ClimbingStats.h"
+#include "CustomComponents/ClimbingMemory.h"
+#include "CustomComponents/ClimbTraceKernels.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DF Resident Bricks"), STAT_ClimbDFResidentBricks, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("DF Bricks Requested"), STAT_ClimbDFBricksRequested, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("DF Samples Computed"), STAT_ClimbDFSamplesComputed, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("DF Query Hits"), STAT_ClimbDFQueryHits, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("DF Query Misses"), STAT_ClimbDFQueryMisses, STATGROUP_Climbing);
+
+void FClimbDistanceFieldCache::Initialize(float InVoxelSize, int32 InBrickResolution, float InMaxDistance)
+{
+	Reset();
+
+	VoxelSize = FMath::Max(InVoxelSize, 1.f);
+	BrickResolution = FMath::Max(InBrickResolution, 1);
+	BrickWorldSize = VoxelSize * BrickResolution;
+	MaxDistance = FMath::Max(InMaxDistance, VoxelSize);
+}
+
+void FClimbDistanceFieldCache::Update(const CS_ClimbTrace::FTraceContext& TraceContext, const FVector& Center, float Radius, const FCollisionQueryParams& QueryParams, int32 MaxBrickRequests, int32 SampleBudget)
+{
+	// 淘汰离角色太远的砖块
+	const float EvictDistanceSquared = FMath::Square(Radius + BrickWorldSize * 2.f);
+	for (auto It = Bricks.CreateIterator(); It; ++It)
+	{
+		const FVector BrickCenter = GetBrickOrigin(It.Key()) + FVector(BrickWorldSize * 0.5f);
+		if (FVector::DistSquared(BrickCenter, Center) > EvictDistanceSquared)
+		{
+			It.RemoveCurrent();
+			Stats.BricksEvicted++;
+		}
+	}
+
+	// 请求角色周围缺失的砖块，离角色近的优先
+	const FIntVector MinCoord = GetBrickCoord(Center - FVector(Radius));
+	const FIntVector MaxCoord = GetBrickCoord(Center + FVector(Radius));
+
+	TArray<FIntVector, TInlineAllocator<64>> MissingCoords;
+	for (int32 X = MinCoord.X; X <= MaxCoord.X; X++)
+	{
+		for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; Y++)
+		{
+			for (int32 Z = MinCoord.Z; Z <= MaxCoord.Z; Z++)
+			{
+				const FIntVector BrickCoord(X, Y, Z);
+				if (!Bricks.Contains(BrickCoord))
+				{
+					MissingCoords.Add(BrickCoord);
+				}
+			}
+		}
+	}
+
+	MissingCoords.Sort([this, &Center](const FIntVector& A, const FIntVector& B)
+	{
+		return FVector::DistSquared(GetBrickOrigin(A), Center) < FVector::DistSquared(GetBrickOrigin(B), Center);
+	});
+
+	for (int32 Index = 0; Index < FMath::Min(MissingCoords.Num(), MaxBrickRequests); Index++)
+	{
+		RequestBrick(TraceContext, MissingCoords[Index], QueryParams);
+	}
+
+	// 在预算内继续构建未完成的砖块
+	for (TPair<FIntVector, FClimbDistanceFieldBrick>& Pair : Bricks)
+	{
+		if (SampleBudget <= 0)
+		{
+			break;
+		}
+
+		if (!Pair.Value.bReady)
+		{
+			SampleBudget -= BuildBrick(Pair.Value, Pair.Key, SampleBudget);
+		}
+	}
+
+	Stats.ResidentBricks = Bricks.Num();
+	SET_DWORD_STAT(STAT_ClimbDFResidentBricks, Stats.ResidentBricks);
+}
+
+void FClimbDistanceFieldCache::Reset()
+{
+	Stats.BricksEvicted += Bricks.Num();
+	Bricks.Reset();
+	Stats.ResidentBricks = 0;
+}
+
+FIntVector FClimbDistanceFieldCache::GetBrickCoord(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / BrickWorldSize),
+		FMath::FloorToInt(Location.Y / BrickWorldSize),
+		FMath::FloorToInt(Location.Z / BrickWorldSize));
+}
+
+FVector FClimbDistanceFieldCache::GetBrickOrigin(const FIntVector& BrickCoord) const
+{
+	return FVector(BrickCoord) * BrickWorldSize;
+}
+
+void FClimbDistanceFieldCache::RequestBrick(const CS_ClimbTrace::FTraceContext& TraceContext, const FIntVector& BrickCoord, const FCollisionQueryParams& QueryParams)
+{
+	LLM_SCOPE_BYTAG(Climbing_DistanceField);
+
+	FClimbDistanceFieldBrick& Brick = Bricks.Add(BrickCoord);
+	Stats.BricksRequested++;
+	INC_DWORD_STAT(STAT_ClimbDFBricksRequested);
+
+	// 收集一次和砖块（外扩最大距离）重叠的组件，构建时只需要对这些组件计算距离
+	const FVector BrickCenter = GetBrickOrigin(BrickCoord) + FVector(BrickWorldSize * 0.5f);
+	const FCollisionShape BrickShape = FCollisionShape::MakeBox(FVector(BrickWorldSize * 0.5f + MaxDistance));
+
+	TArray<FOverlapResult> Overlaps;
+	TraceContext.OverlapMulti(Overlaps, BrickCenter, BrickShape, QueryParams);
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* Component = Overlap.GetComponent();
+		if (!Component)
+		{
+			continue;
+		}
+
+		if (Component->Mobility != EComponentMobility::Static)
+		{
+			// 可移动物体会让缓存失效，这个砖块交给物理检测
+			Brick.bUsable = false;
+			Brick.bReady = true;
+			Brick.Components.Reset();
+			return;
+		}
+
+		Brick.Components.AddUnique(Component);
+	}
+
+	const int32 SamplesPerAxis = BrickResolution + 1;
+	Brick.Distances.SetNumUninitialized(SamplesPerAxis * SamplesPerAxis * SamplesPerAxis);
+	CS_ClimbMemory::NoteArray(Brick.Distances);
+	CS_ClimbMemory::NoteArray(Brick.Components);
+
+	if (Brick.Components.IsEmpty())
+	{
+		// 空砖块，不需要计算
+		for (float& Distance : Brick.Distances)
+		{
+			Distance = MaxDistance;
+		}
+		Brick.bReady = true;
+	}
+}
+
+int32 FClimbDistanceFieldCache::BuildBrick(FClimbDistanceFieldBrick& Brick, const FIntVector& BrickCoord, int32 SampleBudget)
+{
+	const int32 SamplesPerAxis = BrickResolution + 1;
+	const FVector BrickOrigin = GetBrickOrigin(BrickCoord);
+
+	int32 SamplesComputed = 0;
+	while (Brick.NextSampleIndex < Brick.Distances.Num() && SamplesComputed < SampleBudget)
+	{
+		const int32 SampleIndex = Brick.NextSampleIndex++;
+		const int32 X = SampleIndex % SamplesPerAxis;
+		const int32 Y = (SampleIndex / SamplesPerAxis) % SamplesPerAxis;
+		const int32 Z = SampleIndex / (SamplesPerAxis * SamplesPerAxis);
+		const FVector SampleLocation = BrickOrigin + FVector(X, Y, Z) * VoxelSize;
+
+		float MinDistance = MaxDistance;
+		for (const TWeakObjectPtr<UPrimitiveComponent>& Component : Brick.Components)
+		{
+			if (!Component.IsValid())
+			{
+				continue;
+			}
+
+			FVector ClosestPoint;
+			const float Distance = Component->GetDistanceToCollision(SampleLocation, ClosestPoint);
+			if (Distance < 0.f)
+			{
+				// 没有可用的简单碰撞（例如只有复杂碰撞），这个砖块交给物理检测
+				Brick.bUsable = false;
+				Brick.bReady = true;
+				return SamplesComputed + 1;
+			}
+
+			MinDistance = FMath::Min(MinDistance, Distance);
+		}
+
+		Brick.Distances[SampleIndex] = MinDistance;
+		SamplesComputed++;
+	}
+
+	if (Brick.NextSampleIndex >= Brick.Distances.Num())
+	{
+		// 构建完成后不再需要组件列表
+		Brick.bReady = true;
+		Brick.Components.Empty();
+	}
+
+	Stats.SamplesComputed += SamplesComputed;
+	INC_DWORD_STAT_BY(STAT_ClimbDFSamplesComputed, SamplesComputed);
+	return SamplesComputed;
+}
+
+bool FClimbDistanceFieldCache::SampleDistance(const FVector& Location, float& OutDistance) const
+{
+	const FIntVector BrickCoord = GetBrickCoord(Location);
+	const FClimbDistanceFieldBrick* Brick = Bricks.Find(BrickCoord);
+	if (!Brick || !Brick->bReady || !Brick->bUsable)
+	{
+		Stats.QueryMisses++;
+		INC_DWORD_STAT(STAT_ClimbDFQueryMisses);
+		return false;
+	}
+
+	// 砖块内的体素坐标，范围[0, BrickResolution]
+	const FVector Local = (Location - GetBrickOrigin(BrickCoord)) / VoxelSize;
+	const int32 X0 = FMath::Clamp(FMath::FloorToInt(Local.X), 0, BrickResolution - 1);
+	const int32 Y0 = FMath::Clamp(FMath::FloorToInt(Local.Y), 0, BrickResolution - 1);
+	const int32 Z0 = FMath::Clamp(FMath::FloorToInt(Local.Z), 0, BrickResolution - 1);
+	const float FracX = FMath::Clamp(Local.X - X0, 0.f, 1.f);
+	const float FracY = FMath::Clamp(Local.Y - Y0, 0.f, 1.f);
+	const float FracZ = FMath::Clamp(Local.Z - Z0, 0.f, 1.f);
+
+	const int32 SamplesPerAxis = BrickResolution + 1;
+	auto GetSample = [Brick, SamplesPerAxis](int32 X, int32 Y, int32 Z)
+	{
+		return Brick->Distances[X + Y * SamplesPerAxis + Z * SamplesPerAxis * SamplesPerAxis];
+	};
+
+	const float C00 = FMath::Lerp(GetSample(X0, Y0, Z0), GetSample(X0 + 1, Y0, Z0), FracX);
+	const float C10 = FMath::Lerp(GetSample(X0, Y0 + 1, Z0), GetSample(X0 + 1, Y0 + 1, Z0), FracX);
+	const float C01 = FMath::Lerp(GetSample(X0, Y0, Z0 + 1), GetSample(X0 + 1, Y0, Z0 + 1), FracX);
+	const float C11 = FMath::Lerp(GetSample(X0, Y0 + 1, Z0 + 1), GetSample(X0 + 1, Y0 + 1, Z0 + 1), FracX);
+
+	OutDistance = FMath::Lerp(FMath::Lerp(C00, C10, FracY), FMath::Lerp(C01, C11, FracY), FracZ);
+
+	Stats.QueryHits++;
+	INC_DWORD_STAT(STAT_ClimbDFQueryHits);
+	return true;
+}
+
+bool FClimbDistanceFieldCache::SampleSurface(const FVector& Location, FVector& OutSurfacePoint, FVector& OutSurfaceNormal) const
+{
+	float Distance = 0.f;
+	if (!SampleDistance(Location, Distance))
+	{
+		return false;
+	}
+
+	// 中心差分求梯度
+	const float Step = VoxelSize * 0.5f;
+	float PosX, NegX, PosY, NegY, PosZ, NegZ;
+	if (!SampleDistance(Location + FVector(Step, 0.f, 0.f), PosX) || !SampleDistance(Location - FVector(Step, 0.f, 0.f), NegX)
+		|| !SampleDistance(Location + FVector(0.f, Step, 0.f), PosY) || !SampleDistance(Location - FVector(0.f, Step, 0.f), NegY)
+		|| !SampleDistance(Location + FVector(0.f, 0.f, Step), PosZ) || !SampleDistance(Location - FVector(0.f, 0.f, Step), NegZ))
+	{
+		return false;
+	}
+
+	OutSurfaceNormal = FVector(PosX - NegX, PosY - NegY, PosZ - NegZ).GetSafeNormal();
+	if (OutSurfaceNormal.IsNearlyZero())
+	{
+		return false;
+	}
+
+	OutSurfacePoint = Location - OutSurfaceNormal * Distance;
+	return true;
+}
+
+bool FClimbDistanceFieldCache::LineTrace(const FVector& Start, const FVector& End, FHitResult& OutHit) const
+{
+	OutHit = FHitResult(Start, End);
+
+	const FVector TraceDelta = End - Start;
+	const float TraceLength = TraceDelta.Size();
+	const FVector TraceDirection = TraceDelta.GetSafeNormal();
+	const float SurfaceThreshold = VoxelSize * 0.5f;	// 三线性插值后的无符号距离在表面附近不会精确为0
+	const float MinStep = VoxelSize * 0.25f;
+
+	float TraceTime = 0.f;
+	while (true)
+	{
+		const FVector SampleLocation = Start + TraceDirection * TraceTime;
+
+		float Distance = 0.f;
+		if (!SampleDistance(SampleLocation, Distance))
+		{
+			return false;
+		}
+
+		if (Distance <= SurfaceThreshold)
+		{
+			FVector SurfacePoint;
+			FVector SurfaceNormal;
+			if (!SampleSurface(SampleLocation, SurfacePoint, SurfaceNormal))
+			{
+				return false;
+			}
+
+			OutHit.bBlockingHit = true;
+			OutHit.Time = TraceLength > 0.f ? TraceTime / TraceLength : 0.f;
+			OutHit.Distance = TraceTime;
+			OutHit.Location = SampleLocation;
+			OutHit.ImpactPoint = SurfacePoint;
+			OutHit.Normal = SurfaceNormal;
+			OutHit.ImpactNormal = SurfaceNormal;
+			return true;
+		}
+
+		if (TraceTime >= TraceLength)
+		{
+			// 整条线段都在距离场内且没有命中
+			return true;
+		}
+
+		TraceTime = FMath::Min(TraceTime + FMath::Max(Distance - SurfaceThreshold, MinStep), TraceLength);
+	}
+}
+
+SIZE_T FClimbDistanceFieldCache::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize = Bricks.GetAllocatedSize();
+	for (const TPair<FIntVector, FClimbDistanceFieldBrick>& Pair : Bricks)
+	{
+		AllocatedSize += Pair.Value.Distances.GetAllocatedSize() + Pair.Value.Components.GetAllocatedSize();
+	}
+	return AllocatedSize;
+}
@@ -0,0 +1,114 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "CustomComponents/ClimbLandscapeQuery.h"
+
+#include "LandscapeProxy.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+
+
+namespace CS_ClimbLandscape
+{
+	// 单次求交允许的最大步数，避免过长的线段
+	static constexpr int32 MaxLineTraceSteps = 64;
+
+	bool SampleHeight(const ALandscapeProxy* Landscape, const FVector& Location, float& OutHeight)
+	{
+		// 使用简化碰撞高度场，和物理检测命中的数据一致
+		const TOptional<float> Height = Landscape->GetHeightAtLocation(Location, EHeightfieldSource::Simple);
+		if (!Height.IsSet())
+		{
+			return false;
+		}
+
+		OutHeight = Height.GetValue();
+		return true;
+	}
+
+	bool SampleSurface(const ALandscapeProxy* Landscape, const FVector& Location, FVector& OutSurfacePoint, FVector& OutSurfaceNormal)
+	{
+		float CenterHeight = 0.f;
+		if (!SampleHeight(Landscape, Location, CenterHeight))
+		{
+			return false;
+		}
+
+		// 以一个网格间距做中心差分
+		const float SampleStep = Landscape->GetActorScale3D().X;
+		float HeightPosX = CenterHeight, HeightNegX = CenterHeight, HeightPosY = CenterHeight, HeightNegY = CenterHeight;
+		SampleHeight(Landscape, Location + FVector(SampleStep, 0.f, 0.f), HeightPosX);
+		SampleHeight(Landscape, Location - FVector(SampleStep, 0.f, 0.f), HeightNegX);
+		SampleHeight(Landscape, Location + FVector(0.f, SampleStep, 0.f), HeightPosY);
+		SampleHeight(Landscape, Location - FVector(0.f, SampleStep, 0.f), HeightNegY);
+
+		OutSurfacePoint = FVector(Location.X, Location.Y, CenterHeight);
+		OutSurfaceNormal = FVector(HeightNegX - HeightPosX, HeightNegY - HeightPosY, 2.f * SampleStep).GetSafeNormal();
+		return true;
+	}
+
+	bool LineTrace(const ALandscapeProxy* Landscape, UPrimitiveComponent* HitComponent, const FVector& Start, const FVector& End, FHitResult& OutHit)
+	{
+		OutHit = FHitResult(Start, End);
+
+		const FVector TraceDelta = End - Start;
+		const float StepSize = FMath::Max(Landscape->GetActorScale3D().X * 0.5f, 1.f);	// 半个网格间距
+		const int32 NumSteps = FMath::Clamp(FMath::CeilToInt(TraceDelta.Size() / StepSize), 1, MaxLineTraceSteps);
+
+		float PrevHeight = 0.f;
+		if (!SampleHeight(Landscape, Start, PrevHeight))
+		{
+			return false;
+		}
+
+		float PrevGap = Start.Z - PrevHeight;	// 在地形上方为正
+		if (PrevGap <= 0.f)
+		{
+			// 起点在地形下方，交给物理检测处理
+			return false;
+		}
+
+		float PrevTime = 0.f;
+		for (int32 Step = 1; Step <= NumSteps; Step++)
+		{
+			const float Time = static_cast<float>(Step) / NumSteps;
+			const FVector SampleLocation = Start + TraceDelta * Time;
+
+			float Height = 0.f;
+			if (!SampleHeight(Landscape, SampleLocation, Height))
+			{
+				// 离开地形范围
+				return false;
+			}
+
+			const float Gap = SampleLocation.Z - Height;
+			if (Gap <= 0.f)
+			{
+				// 在上一个采样点和当前采样点之间穿过地形，线性插值求交点
+				const float HitTime = FMath::Lerp(PrevTime, Time, PrevGap / (PrevGap - Gap));
+
+				FVector SurfacePoint;
+				FVector SurfaceNormal;
+				if (!SampleSurface(Landscape, Start + TraceDelta * HitTime, SurfacePoint, SurfaceNormal))
+				{
+					return false;
+				}
+
+				OutHit.bBlockingHit = true;
+				OutHit.Time = HitTime;
+				OutHit.Distance = TraceDelta.Size() * HitTime;
+				OutHit.Location = SurfacePoint;
+				OutHit.ImpactPoint = SurfacePoint;
+				OutHit.Normal = SurfaceNormal;
+				OutHit.ImpactNormal = SurfaceNormal;
+				OutHit.Component = HitComponent;
+				OutHit.HitObjectHandle = FActorInstanceHandle(const_cast<ALandscapeProxy*>(Landscape));
+				return true;
+			}
+
+			PrevTime = Time;
+			PrevGap = Gap;
+		}
+
+		return false;
+	}
+}
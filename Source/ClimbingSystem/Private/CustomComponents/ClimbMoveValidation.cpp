@@ -0,0 +1,190 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "CustomComponents/ClimbMoveValidation.h"
+
+#include "CustomComponents/ClimbingStats.h"
+#include "CustomComponents/ClimbingMemory.h"
+#include "Components/PrimitiveComponent.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Validation Cached Primitives"), STAT_ClimbValidationCachedPrimitives, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Validation Cache Lookups"), STAT_ClimbValidationCacheLookups, STATGROUP_Climbing);
+
+void FClimbGeometryCache::Initialize(float InCellSize, int32 InMaxSamplesPerPrimitive, int32 InMaxPrimitives)
+{
+	Reset();
+
+	CellSize = FMath::Max(InCellSize, 1.f);
+	MaxSamplesPerPrimitive = FMath::Max(InMaxSamplesPerPrimitive, 1);
+	MaxPrimitives = FMath::Max(InMaxPrimitives, 1);
+}
+
+void FClimbGeometryCache::Reset()
+{
+	Primitives.Reset();
+	Stats = FClimbValidationStats();
+}
+
+bool FClimbGeometryCache::IsCacheable(const UPrimitiveComponent* Component)
+{
+	// 可移动的组件随时会变化，只能用完整检测
+	return Component && Component->Mobility == EComponentMobility::Static;
+}
+
+FClimbPrimitiveGeometry* FClimbGeometryCache::FindEntry(const UPrimitiveComponent* Component)
+{
+	FClimbPrimitiveGeometry* Entry = Primitives.Find(Component);
+	if (Entry && !Entry->ComponentToWorld.Equals(Component->GetComponentTransform(), KINDA_SMALL_NUMBER))
+	{
+		// 组件被重新放置过，缓存的采样已经无效
+		Stats.CachedSamples -= Entry->Samples.Num();
+		Primitives.Remove(Component);
+		return nullptr;
+	}
+	return Entry;
+}
+
+FIntVector FClimbGeometryCache::GetCellCoord(const FVector& LocalPoint) const
+{
+	return FIntVector(
+		FMath::FloorToInt(LocalPoint.X / CellSize),
+		FMath::FloorToInt(LocalPoint.Y / CellSize),
+		FMath::FloorToInt(LocalPoint.Z / CellSize));
+}
+
+EClimbGeometryCheck FClimbGeometryCache::CheckSurfacePoint(const UPrimitiveComponent* Component, const FVector& Point, const FVector& Normal, float Tolerance, float MinNormalDot)
+{
+	INC_DWORD_STAT(STAT_ClimbValidationCacheLookups);
+
+	if (!IsCacheable(Component))
+	{
+		return EClimbGeometryCheck::Unknown;
+	}
+
+	// 包围盒只依赖组件本身，不需要缓存条目也能拒绝明显错误的点
+	const FTransform& ComponentToWorld = Component->GetComponentTransform();
+	const FVector LocalPoint = ComponentToWorld.InverseTransformPosition(Point);
+	const FVector LocalTolerance = FVector(Tolerance) / ComponentToWorld.GetScale3D().GetAbs().ComponentMax(FVector(KINDA_SMALL_NUMBER));
+
+	const FClimbPrimitiveGeometry* Entry = FindEntry(Component);
+	const FBox LocalBounds = Entry ? Entry->LocalBounds : Component->CalcBounds(FTransform::Identity).GetBox();
+	if (!LocalBounds.ExpandBy(LocalTolerance).IsInside(LocalPoint))
+	{
+		return EClimbGeometryCheck::Rejected;
+	}
+
+	if (!Entry)
+	{
+		return EClimbGeometryCheck::Unknown;
+	}
+
+	const FVector3f LocalNormal(ComponentToWorld.InverseTransformVectorNoScale(Normal));
+	const float ToleranceSquared = FMath::Square(Tolerance);
+	const int32 CellRadius = FMath::CeilToInt(LocalTolerance.GetMax() / CellSize);
+	const FIntVector CenterCell = GetCellCoord(LocalPoint);
+
+	// 在容差覆盖的格子里查找方向一致的已验证采样
+	for (int32 X = -CellRadius; X <= CellRadius; X++)
+	{
+		for (int32 Y = -CellRadius; Y <= CellRadius; Y++)
+		{
+			for (int32 Z = -CellRadius; Z <= CellRadius; Z++)
+			{
+				const FClimbSurfaceSample* Sample = Entry->Samples.Find(CenterCell + FIntVector(X, Y, Z));
+				if (!Sample || FVector3f::DotProduct(Sample->Normal, LocalNormal) < MinNormalDot)
+				{
+					continue;
+				}
+
+				if (FVector::DistSquared(ComponentToWorld.TransformPosition(FVector(Sample->Point)), Point) <= ToleranceSquared)
+				{
+					return EClimbGeometryCheck::Accepted;
+				}
+			}
+		}
+	}
+
+	return EClimbGeometryCheck::Unknown;
+}
+
+void FClimbGeometryCache::AddSurfaceSample(const UPrimitiveComponent* Component, const FVector& Point, const FVector& Normal)
+{
+	LLM_SCOPE_BYTAG(Climbing_Probes);
+
+	if (!IsCacheable(Component))
+	{
+		return;
+	}
+
+	FClimbPrimitiveGeometry* Entry = FindEntry(Component);
+	if (!Entry)
+	{
+		if (Primitives.Num() >= MaxPrimitives)
+		{
+			// 缓存已满时先清掉已经销毁的组件，仍然满就不再缓存新组件
+			for (auto It = Primitives.CreateIterator(); It; ++It)
+			{
+				if (!It.Key().IsValid())
+				{
+					Stats.CachedSamples -= It.Value().Samples.Num();
+					It.RemoveCurrent();
+				}
+			}
+
+			if (Primitives.Num() >= MaxPrimitives)
+			{
+				return;
+			}
+		}
+
+		Entry = &Primitives.Add(Component);
+		Entry->ComponentToWorld = Component->GetComponentTransform();
+		Entry->LocalBounds = Component->CalcBounds(FTransform::Identity).GetBox();
+	}
+
+	if (Entry->Samples.Num() >= MaxSamplesPerPrimitive)
+	{
+		return;
+	}
+
+	const FVector LocalPoint = Entry->ComponentToWorld.InverseTransformPosition(Point);
+	const FIntVector Cell = GetCellCoord(LocalPoint);
+	if (!Entry->Samples.Contains(Cell))
+	{
+		Entry->Samples.Add(Cell, { FVector3f(LocalPoint), FVector3f(Entry->ComponentToWorld.InverseTransformVectorNoScale(Normal)) });
+		Stats.CachedSamples++;
+		CS_ClimbMemory::NoteAllocation(sizeof(FClimbSurfaceSample));
+	}
+
+	Stats.CachedPrimitives = Primitives.Num();
+	SET_DWORD_STAT(STAT_ClimbValidationCachedPrimitives, Stats.CachedPrimitives);
+}
+
+SIZE_T FClimbGeometryCache::GetAllocatedSize() const
+{
+	SIZE_T Size = Primitives.GetAllocatedSize();
+	for (const TPair<TWeakObjectPtr<const UPrimitiveComponent>, FClimbPrimitiveGeometry>& Pair : Primitives)
+	{
+		Size += Pair.Value.Samples.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void UClimbValidationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	GeometryCache.Initialize(25.f, 256, 1024);
+}
+
+void UClimbValidationSubsystem::Deinitialize()
+{
+	GeometryCache.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UClimbValidationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
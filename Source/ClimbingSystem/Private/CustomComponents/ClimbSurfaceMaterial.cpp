@@ -0,0 +1,84 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "CustomComponents/ClimbSurfaceMaterial.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/HitResult.h"
+
+void FClimbSurfaceMaterialCache::Initialize(const TMap<UPhysicalMaterial*, FClimbSurfaceProperties>& InOverrides, const FClimbSurfaceProperties& InDefaultProperties)
+{
+	Reset();
+
+	Overrides.Reserve(InOverrides.Num());
+	for (const TPair<UPhysicalMaterial*, FClimbSurfaceProperties>& Override : InOverrides)
+	{
+		if (Override.Key)
+		{
+			Overrides.Add(Override.Key, Override.Value);
+		}
+	}
+	DefaultProperties = InDefaultProperties;
+}
+
+void FClimbSurfaceMaterialCache::Reset()
+{
+	Overrides.Reset();
+	Resolved.Reset();
+	LastMaterial = TObjectKey<UPhysicalMaterial>();
+	LastProperties = nullptr;
+}
+
+const FClimbSurfaceProperties& FClimbSurfaceMaterialCache::Resolve(const FHitResult& Hit) const
+{
+	const UPhysicalMaterial* Material = Hit.PhysMaterial.Get();
+	if (!Material)
+	{
+		// 距离场、地形快速路径和快照还原的命中没有物理材质
+		// 没有物理体的组件（例如没有物理资产的骨骼网格）使用默认属性
+		const UPrimitiveComponent* Component = Hit.GetComponent();
+		const FBodyInstance* BodyInstance = Component ? Component->GetBodyInstance() : nullptr;
+		if (!BodyInstance)
+		{
+			return DefaultProperties;
+		}
+		Material = BodyInstance->GetSimplePhysicalMaterial();
+	}
+
+	return Resolve(Material);
+}
+
+const FClimbSurfaceProperties& FClimbSurfaceMaterialCache::Resolve(const UPhysicalMaterial* Material) const
+{
+	if (!Material)
+	{
+		return DefaultProperties;
+	}
+
+	const TObjectKey<UPhysicalMaterial> Key(Material);
+	if (LastProperties && Key == LastMaterial)
+	{
+		return *LastProperties;
+	}
+
+	const FClimbSurfaceProperties* Properties = Resolved.Find(Key);
+	if (!Properties)
+	{
+		if (const UClimbPhysicalMaterial* ClimbMaterial = Cast<UClimbPhysicalMaterial>(Material))
+		{
+			Properties = &Resolved.Add(Key, ClimbMaterial->ClimbSurface);
+		}
+		else if (const FClimbSurfaceProperties* Override = Overrides.Find(Key))
+		{
+			Properties = &Resolved.Add(Key, *Override);
+		}
+		else
+		{
+			Properties = &Resolved.Add(Key, DefaultProperties);
+		}
+	}
+
+	LastMaterial = Key;
+	LastProperties = Properties;
+	return *Properties;
+}
@@ -0,0 +1,323 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "CustomComponents/ClimbTelemetry.h"
+
+#include "CustomComponents/ClimbingStats.h"
+#include "Containers/Queue.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+#include <atomic>
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Telemetry Records"), STAT_ClimbTelemetryRecords, STATGROUP_Climbing);
+
+static int32 GClimbTelemetryEnabled = 0;
+static FAutoConsoleVariableRef CVarClimbTelemetry(
+	TEXT("climb.Telemetry"),
+	GClimbTelemetryEnabled,
+	TEXT("Records climbing events and per-frame probe costs to Saved/ClimbTelemetry. Also enabled by -ClimbTelemetry."));
+
+static FAutoConsoleCommand GClimbTelemetryFlushCommand(
+	TEXT("Climb.Telemetry.Flush"),
+	TEXT("Hands the partially filled telemetry chunk to the writer thread."),
+	FConsoleCommandDelegate::CreateStatic(&CS_ClimbTelemetry::Flush));
+
+FClimbTelemetryChunk::FClimbTelemetryChunk()
+{
+	Times.Reserve(Capacity);
+	LocationX.Reserve(Capacity);
+	LocationY.Reserve(Capacity);
+	LocationZ.Reserve(Capacity);
+	Events.Reserve(Capacity);
+	NumTraces.Reserve(Capacity);
+	Costs.Reserve(Capacity);
+}
+
+void FClimbTelemetryChunk::Add(const FClimbTelemetryRecord& Record)
+{
+	Times.Add(Record.Time);
+	LocationX.Add(Record.Location.X);
+	LocationY.Add(Record.Location.Y);
+	LocationZ.Add(Record.Location.Z);
+	Events.Add(static_cast<uint8>(Record.Event));
+	NumTraces.Add(Record.NumTraces);
+	Costs.Add(Record.CostMicroseconds);
+}
+
+FClimbTelemetryRecord FClimbTelemetryChunk::Get(int32 Index) const
+{
+	FClimbTelemetryRecord Record;
+	Record.Time = Times[Index];
+	Record.Location = FVector3f(LocationX[Index], LocationY[Index], LocationZ[Index]);
+	Record.Event = static_cast<EClimbTelemetryEvent>(Events[Index]);
+	Record.NumTraces = NumTraces[Index];
+	Record.CostMicroseconds = Costs[Index];
+	return Record;
+}
+
+bool FClimbTelemetryChunk::Serialize(FArchive& Ar)
+{
+	uint32 Magic = ChunkMagic;
+	int32 Count = Num();
+	Ar << Magic;
+	Ar << Count;
+
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError() || Magic != ChunkMagic || Count < 0 || Count > Capacity)
+		{
+			return false;
+		}
+
+		Times.SetNumUninitialized(Count);
+		LocationX.SetNumUninitialized(Count);
+		LocationY.SetNumUninitialized(Count);
+		LocationZ.SetNumUninitialized(Count);
+		Events.SetNumUninitialized(Count);
+		NumTraces.SetNumUninitialized(Count);
+		Costs.SetNumUninitialized(Count);
+	}
+
+	// 按列整块读写
+	Ar.Serialize(Times.GetData(), Times.NumBytes());
+	Ar.Serialize(LocationX.GetData(), LocationX.NumBytes());
+	Ar.Serialize(LocationY.GetData(), LocationY.NumBytes());
+	Ar.Serialize(LocationZ.GetData(), LocationZ.NumBytes());
+	Ar.Serialize(Events.GetData(), Events.NumBytes());
+	Ar.Serialize(NumTraces.GetData(), NumTraces.NumBytes());
+	Ar.Serialize(Costs.GetData(), Costs.NumBytes());
+
+	return !Ar.IsError();
+}
+
+namespace CS_ClimbTelemetry
+{
+	// 交给写入线程的命令：切换文件或者写入一个数据块
+	struct FWriteCommand
+	{
+		FString NewFilePath;
+		FString MapName;
+		TUniquePtr<FClimbTelemetryChunk> Chunk;
+	};
+
+	/**
+	 * 后台写入线程，游戏线程是唯一的生产者
+	 */
+	class FWriter : public FRunnable
+	{
+	public:
+		FWriter()
+		{
+			WorkEvent = FPlatformProcess::GetSynchEventFromPool();
+			Thread = FRunnableThread::Create(this, TEXT("ClimbTelemetryWriter"), 0, TPri_BelowNormal);
+		}
+
+		virtual ~FWriter() override
+		{
+			Shutdown();
+			FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		}
+
+		void Enqueue(FWriteCommand&& Command)
+		{
+			Commands.Enqueue(MoveTemp(Command));
+			WorkEvent->Trigger();
+		}
+
+		void Shutdown()
+		{
+			if (Thread)
+			{
+				bStopping = true;
+				WorkEvent->Trigger();
+				Thread->WaitForCompletion();
+				delete Thread;
+				Thread = nullptr;
+			}
+		}
+
+		virtual uint32 Run() override
+		{
+			while (true)
+			{
+				WorkEvent->Wait();
+
+				FWriteCommand Command;
+				while (Commands.Dequeue(Command))
+				{
+					Process(Command);
+				}
+
+				if (bStopping)
+				{
+					break;
+				}
+			}
+
+			if (FileWriter)
+			{
+				FileWriter->Close();
+				FileWriter.Reset();
+			}
+			return 0;
+		}
+
+	private:
+		void Process(FWriteCommand& Command)
+		{
+			if (!Command.NewFilePath.IsEmpty())
+			{
+				if (FileWriter)
+				{
+					FileWriter->Close();
+				}
+
+				FileWriter.Reset(IFileManager::Get().CreateFileWriter(*Command.NewFilePath));
+				if (FileWriter)
+				{
+					uint32 Magic = FClimbTelemetryChunk::FileMagic;
+					uint32 Version = FClimbTelemetryChunk::Version;
+					*FileWriter << Magic;
+					*FileWriter << Version;
+					*FileWriter << Command.MapName;
+				}
+			}
+
+			if (Command.Chunk && FileWriter)
+			{
+				Command.Chunk->Serialize(*FileWriter);
+				FileWriter->Flush();
+			}
+		}
+
+		TQueue<FWriteCommand, EQueueMode::Spsc> Commands;
+		FEvent* WorkEvent = nullptr;
+		FRunnableThread* Thread = nullptr;
+		TUniquePtr<FArchive> FileWriter;
+		std::atomic<bool> bStopping = false;
+	};
+
+	// 以下状态只在游戏线程上访问
+	static TUniquePtr<FWriter> GWriter;
+	static TUniquePtr<FClimbTelemetryChunk> GCurrentChunk;
+	static FString GCurrentMapName;
+
+	static void ShutdownWriter()
+	{
+		Flush();
+		GWriter.Reset();
+	}
+
+	bool IsEnabled()
+	{
+		static const bool bCommandLineEnabled = FParse::Param(FCommandLine::Get(), TEXT("ClimbTelemetry"));
+		return GClimbTelemetryEnabled != 0 || bCommandLineEnabled;
+	}
+
+	FString GetTelemetryDirectory()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("ClimbTelemetry");
+	}
+
+	void Record(const UWorld* World, EClimbTelemetryEvent Event, const FVector& Location, uint16 NumTraces, float CostMicroseconds)
+	{
+		check(IsInGameThread());
+
+		if (!World || !IsEnabled())
+		{
+			return;
+		}
+
+		if (!GWriter)
+		{
+			GWriter = MakeUnique<FWriter>();
+			FCoreDelegates::OnEnginePreExit.AddStatic(&ShutdownWriter);
+		}
+
+		const FString MapName = World->GetMapName();
+		if (MapName != GCurrentMapName)
+		{
+			// 每张地图一个文件，切换地图前写完上一张地图的数据
+			Flush();
+
+			FWriteCommand Command;
+			Command.MapName = MapName;
+			Command.NewFilePath = GetTelemetryDirectory() / FString::Printf(TEXT("%s_%s_%u.cltm"), *MapName, *FDateTime::Now().ToString(), FPlatformProcess::GetCurrentProcessId());
+			GWriter->Enqueue(MoveTemp(Command));
+			GCurrentMapName = MapName;
+		}
+
+		if (!GCurrentChunk)
+		{
+			GCurrentChunk = MakeUnique<FClimbTelemetryChunk>();
+		}
+
+		FClimbTelemetryRecord Record;
+		Record.Time = World->GetTimeSeconds();
+		Record.Location = FVector3f(Location);
+		Record.Event = Event;
+		Record.NumTraces = NumTraces;
+		Record.CostMicroseconds = CostMicroseconds;
+		GCurrentChunk->Add(Record);
+
+		INC_DWORD_STAT(STAT_ClimbTelemetryRecords);
+
+		if (GCurrentChunk->IsFull())
+		{
+			Flush();
+		}
+	}
+
+	void Flush()
+	{
+		check(IsInGameThread());
+
+		if (GWriter && GCurrentChunk && GCurrentChunk->Num() > 0)
+		{
+			FWriteCommand Command;
+			Command.Chunk = MoveTemp(GCurrentChunk);
+			GWriter->Enqueue(MoveTemp(Command));
+		}
+	}
+
+	bool ReadFile(const FString& FilePath, FString& OutMapName, TFunctionRef<void(const FClimbTelemetryChunk&)> ChunkCallback)
+	{
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+		if (!Reader)
+		{
+			return false;
+		}
+
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		*Reader << Magic;
+		*Reader << Version;
+		if (Magic != FClimbTelemetryChunk::FileMagic || Version != FClimbTelemetryChunk::Version)
+		{
+			return false;
+		}
+		*Reader << OutMapName;
+
+		FClimbTelemetryChunk Chunk;
+		while (!Reader->AtEnd())
+		{
+			if (!Chunk.Serialize(*Reader))
+			{
+				// 进程被中断时最后一个数据块可能不完整
+				break;
+			}
+			ChunkCallback(Chunk);
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,216 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "CustomComponents/ClimbTraversalStateMachine.h"
+
+#include "CustomComponents/ClimbingStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traversal Probes"), STAT_ClimbTraversalProbes, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traversal Transitions"), STAT_ClimbTraversalTransitions, STATGROUP_Climbing);
+
+namespace
+{
+	constexpr int32 StateBit(EClimbTraversalState State)
+	{
+		return 1 << static_cast<int32>(State);
+	}
+
+	constexpr int32 ProbeBit(EClimbProbe Probe)
+	{
+		return 1 << static_cast<int32>(Probe);
+	}
+}
+
+void FClimbTraversalStateMachine::Initialize(const UDataTable* StateTable)
+{
+	for (int32 Index = 0; Index < static_cast<int32>(EClimbTraversalState::MAX); Index++)
+	{
+		Rows[Index] = MakeDefaultRow(static_cast<EClimbTraversalState>(Index));
+	}
+
+	if (StateTable)
+	{
+		// 数据表中的行覆盖默认描述
+		for (const TPair<FName, uint8*>& Row : StateTable->GetRowMap())
+		{
+			const FClimbTraversalStateRow* StateRow = reinterpret_cast<const FClimbTraversalStateRow*>(Row.Value);
+			if (StateRow && StateRow->State < EClimbTraversalState::MAX)
+			{
+				Rows[static_cast<int32>(StateRow->State)] = *StateRow;
+			}
+		}
+	}
+
+	State = EClimbTraversalState::Idle;
+	ResetStats();
+}
+
+bool FClimbTraversalStateMachine::CanTransitionTo(EClimbTraversalState NewState) const
+{
+	return NewState < EClimbTraversalState::MAX
+		&& (Rows[static_cast<int32>(State)].AllowedTransitions & StateBit(NewState)) != 0;
+}
+
+bool FClimbTraversalStateMachine::TransitionTo(EClimbTraversalState NewState)
+{
+	if (!CanTransitionTo(NewState))
+	{
+		return false;
+	}
+
+	if (NewState != State)
+	{
+		EnterState(NewState, true);
+	}
+	return true;
+}
+
+void FClimbTraversalStateMachine::SyncState(EClimbTraversalState ObservedState)
+{
+	if (ObservedState != State && ObservedState < EClimbTraversalState::MAX)
+	{
+		EnterState(ObservedState, CanTransitionTo(ObservedState));
+	}
+}
+
+bool FClimbTraversalStateMachine::WantsProbe(EClimbProbe Probe)
+{
+	if ((Rows[static_cast<int32>(State)].Probes & ProbeBit(Probe)) == 0)
+	{
+		return false;
+	}
+
+	Stats[static_cast<int32>(State)].ProbeCounts[static_cast<int32>(Probe)]++;
+	INC_DWORD_STAT(STAT_ClimbTraversalProbes);
+	return true;
+}
+
+void FClimbTraversalStateMachine::Tick(float DeltaTime)
+{
+	Stats[static_cast<int32>(State)].ResidencyTime += DeltaTime;
+}
+
+void FClimbTraversalStateMachine::ResetStats()
+{
+	for (FClimbTraversalStateStats& StateStats : Stats)
+	{
+		StateStats = FClimbTraversalStateStats();
+	}
+}
+
+FString FClimbTraversalStateMachine::DescribeStats() const
+{
+	double TotalTime = 0.0;
+	for (const FClimbTraversalStateStats& StateStats : Stats)
+	{
+		TotalTime += StateStats.ResidencyTime;
+	}
+
+	FString Result = FString::Printf(TEXT("Current state: %s\n"), GetStateName(State));
+	for (int32 Index = 0; Index < static_cast<int32>(EClimbTraversalState::MAX); Index++)
+	{
+		const FClimbTraversalStateStats& StateStats = Stats[Index];
+		Result += FString::Printf(TEXT("  %-12s %8.2fs (%5.1f%%)  entries %4d (unexpected %d)  probes %6d"),
+			GetStateName(static_cast<EClimbTraversalState>(Index)),
+			StateStats.ResidencyTime,
+			TotalTime > 0.0 ? StateStats.ResidencyTime / TotalTime * 100.0 : 0.0,
+			StateStats.Entries,
+			StateStats.UnexpectedEntries,
+			StateStats.GetTotalProbeCount());
+
+		for (int32 ProbeIndex = 0; ProbeIndex < static_cast<int32>(EClimbProbe::MAX); ProbeIndex++)
+		{
+			if (StateStats.ProbeCounts[ProbeIndex] > 0)
+			{
+				Result += FString::Printf(TEXT("  %s=%d"),
+					*UEnum::GetDisplayValueAsText(static_cast<EClimbProbe>(ProbeIndex)).ToString(),
+					StateStats.ProbeCounts[ProbeIndex]);
+			}
+		}
+		Result += TEXT("\n");
+	}
+	return Result;
+}
+
+const TCHAR* FClimbTraversalStateMachine::GetStateName(EClimbTraversalState InState)
+{
+	switch (InState)
+	{
+	case EClimbTraversalState::Idle:		return TEXT("Idle");
+	case EClimbTraversalState::Approaching:	return TEXT("Approaching");
+	case EClimbTraversalState::Mounting:	return TEXT("Mounting");
+	case EClimbTraversalState::Climbing:	return TEXT("Climbing");
+	case EClimbTraversalState::Dashing:		return TEXT("Dashing");
+	case EClimbTraversalState::ToppingOut:	return TEXT("ToppingOut");
+	case EClimbTraversalState::Vaulting:	return TEXT("Vaulting");
+	case EClimbTraversalState::Dropping:	return TEXT("Dropping");
+	default:								return TEXT("Invalid");
+	}
+}
+
+void FClimbTraversalStateMachine::EnterState(EClimbTraversalState NewState, bool bExpected)
+{
+	State = NewState;
+
+	FClimbTraversalStateStats& StateStats = Stats[static_cast<int32>(NewState)];
+	StateStats.Entries++;
+	if (!bExpected)
+	{
+		StateStats.UnexpectedEntries++;
+	}
+	INC_DWORD_STAT(STAT_ClimbTraversalTransitions);
+}
+
+FClimbTraversalStateRow FClimbTraversalStateMachine::MakeDefaultRow(EClimbTraversalState InState)
+{
+	FClimbTraversalStateRow Row;
+	Row.State = InState;
+
+	switch (InState)
+	{
+	case EClimbTraversalState::Idle:
+		Row.AllowedTransitions = StateBit(EClimbTraversalState::Approaching) | StateBit(EClimbTraversalState::Mounting)
+			| StateBit(EClimbTraversalState::Climbing) | StateBit(EClimbTraversalState::Vaulting) | StateBit(EClimbTraversalState::Dropping);
+		break;
+	case EClimbTraversalState::Approaching:
+		Row.Probes = ProbeBit(EClimbProbe::StartClimb) | ProbeBit(EClimbProbe::ClimbDownLedge) | ProbeBit(EClimbProbe::Vault);
+		Row.AllowedTransitions = StateBit(EClimbTraversalState::Idle) | StateBit(EClimbTraversalState::Mounting)
+			| StateBit(EClimbTraversalState::Climbing) | StateBit(EClimbTraversalState::Vaulting) | StateBit(EClimbTraversalState::Dropping);
+		break;
+	case EClimbTraversalState::Mounting:
+		// 切换窗口中已经进入攀爬模式，需要贴住墙面
+		Row.Probes = ProbeBit(EClimbProbe::ClimbableSurface);
+		Row.AllowedTransitions = StateBit(EClimbTraversalState::Climbing) | StateBit(EClimbTraversalState::Dashing) | StateBit(EClimbTraversalState::Idle)
+			| StateBit(EClimbTraversalState::Approaching) | StateBit(EClimbTraversalState::Dropping);
+		break;
+	case EClimbTraversalState::Climbing:
+		Row.Probes = ProbeBit(EClimbProbe::ClimbableSurface) | ProbeBit(EClimbProbe::ReachableGround)
+			| ProbeBit(EClimbProbe::TopOut) | ProbeBit(EClimbProbe::Corner);
+		Row.AllowedTransitions = StateBit(EClimbTraversalState::Climbing) | StateBit(EClimbTraversalState::Dashing)
+			| StateBit(EClimbTraversalState::ToppingOut) | StateBit(EClimbTraversalState::Idle)
+			| StateBit(EClimbTraversalState::Approaching) | StateBit(EClimbTraversalState::Dropping);
+		break;
+	case EClimbTraversalState::Dashing:
+		// 冲刺轨迹已经校验过，只需要贴住墙面
+		Row.Probes = ProbeBit(EClimbProbe::ClimbableSurface);
+		Row.AllowedTransitions = StateBit(EClimbTraversalState::Climbing) | StateBit(EClimbTraversalState::Dashing)
+			| StateBit(EClimbTraversalState::Dropping);
+		break;
+	case EClimbTraversalState::ToppingOut:
+	case EClimbTraversalState::Vaulting:
+		// 根动作驱动，离开墙面或者落地时结束攀爬
+		Row.Probes = ProbeBit(EClimbProbe::ClimbableSurface) | ProbeBit(EClimbProbe::ReachableGround);
+		Row.AllowedTransitions = StateBit(EClimbTraversalState::Idle) | StateBit(EClimbTraversalState::Approaching)
+			| StateBit(EClimbTraversalState::Climbing) | StateBit(EClimbTraversalState::Dropping);
+		break;
+	case EClimbTraversalState::Dropping:
+		Row.Probes = ProbeBit(EClimbProbe::WallRegrab);
+		Row.AllowedTransitions = StateBit(EClimbTraversalState::Idle) | StateBit(EClimbTraversalState::Approaching)
+			| StateBit(EClimbTraversalState::Climbing) | StateBit(EClimbTraversalState::Mounting);
+		break;
+	default:
+		break;
+	}
+
+	return Row;
+}
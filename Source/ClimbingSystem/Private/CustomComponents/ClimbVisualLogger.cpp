@@ -0,0 +1,92 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "CustomComponents/ClimbVisualLogger.h"
+
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY(LogClimbProbe);
+
+#if CLIMB_VLOG_ENABLED
+
+namespace CS_ClimbVLog
+{
+	static int32 GSampleInterval = 1;
+	static FAutoConsoleVariableRef CVarSampleInterval(
+		TEXT("climb.VLog.SampleInterval"),
+		GSampleInterval,
+		TEXT("Records climb probes into the Visual Logger every N frames while it is recording (0 disables recording)."));
+
+	static const TCHAR* GProbeLabel = TEXT("Probe");
+
+	bool ShouldRecord()
+	{
+		return FVisualLogger::IsRecording()
+			&& GSampleInterval > 0
+			&& GFrameCounter % GSampleInterval == 0;
+	}
+
+	const TCHAR* GetProbeLabel()
+	{
+		return GProbeLabel;
+	}
+
+	FProbeScope::FProbeScope(const TCHAR* Label)
+		: PreviousLabel(GProbeLabel)
+	{
+		GProbeLabel = Label;
+	}
+
+	FProbeScope::~FProbeScope()
+	{
+		GProbeLabel = PreviousLabel;
+	}
+
+	void LineTrace(const UObject* Owner, const FVector& Start, const FVector& End, const FHitResult& Hit)
+	{
+		// 命中时线段画到命中点，并记录命中的法线
+		const FVector TraceEnd = Hit.bBlockingHit ? Hit.Location : End;
+		const FColor Color = Hit.bBlockingHit ? FColor::Green : FColor::Red;
+		UE_VLOG_SEGMENT(Owner, LogClimbProbe, Verbose, Start, TraceEnd, Color, TEXT("%s"), GProbeLabel);
+
+		if (Hit.bBlockingHit)
+		{
+			UE_VLOG_ARROW(Owner, LogClimbProbe, Verbose, Hit.ImpactPoint, Hit.ImpactPoint + Hit.ImpactNormal * 30.f, FColor::Cyan, TEXT("%s: %s"), GProbeLabel, *GetNameSafe(Hit.GetComponent()));
+		}
+	}
+
+	void CapsuleTrace(const UObject* Owner, const FVector& Start, const FVector& End, float Radius, float HalfHeight, const TArray<FHitResult>& Hits)
+	{
+		const FColor Color = Hits.IsEmpty() ? FColor::Red : FColor::Green;
+		UE_VLOG_CAPSULE(Owner, LogClimbProbe, Verbose, Start - FVector::UpVector * HalfHeight, HalfHeight, Radius, FQuat::Identity, Color, TEXT("%s start"), GProbeLabel);
+		UE_VLOG_CAPSULE(Owner, LogClimbProbe, Verbose, End - FVector::UpVector * HalfHeight, HalfHeight, Radius, FQuat::Identity, Color, TEXT("%s end (%d hits)"), GProbeLabel, Hits.Num());
+
+		for (const FHitResult& Hit : Hits)
+		{
+			UE_VLOG_ARROW(Owner, LogClimbProbe, Verbose, Hit.ImpactPoint, Hit.ImpactPoint + Hit.ImpactNormal * 30.f, FColor::Cyan, TEXT("%s"), *GetNameSafe(Hit.GetComponent()));
+		}
+	}
+
+	void QueryBounds(const UObject* Owner, const FBox& Bounds, int32 NumComponents)
+	{
+		UE_VLOG_BOX(Owner, LogClimbProbe, Verbose, Bounds, FColor::Silver, TEXT("%s broadphase (%d components)"), GProbeLabel, NumComponents);
+	}
+
+	void Surface(const UObject* Owner, const TCHAR* Label, const FVector& Location, const FVector& Normal)
+	{
+		UE_VLOG_LOCATION(Owner, LogClimbProbe, Log, Location, 10.f, FColor::Green, TEXT("%s"), Label);
+		UE_VLOG_ARROW(Owner, LogClimbProbe, Log, Location, Location + Normal * 100.f, FColor::Green, TEXT(""));
+	}
+
+	void Segment(const UObject* Owner, const TCHAR* Label, const FVector& Start, const FVector& End, const FColor& Color)
+	{
+		UE_VLOG_SEGMENT(Owner, LogClimbProbe, Log, Start, End, Color, TEXT("%s"), Label);
+	}
+
+	void Location(const UObject* Owner, const TCHAR* Label, const FVector& Location, const FColor& Color)
+	{
+		UE_VLOG_LOCATION(Owner, LogClimbProbe, Log, Location, 10.f, Color, TEXT("%s"), Label);
+	}
+}
+
+#endif
@@ -0,0 +1,56 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "CustomComponents/ClimbingMemory.h"
+
+#include "CustomComponents/ClimbingStats.h"
+
+LLM_DEFINE_TAG(Climbing);
+LLM_DEFINE_TAG(Climbing_Probes);
+LLM_DEFINE_TAG(Climbing_DistanceField);
+LLM_DEFINE_TAG(Climbing_Trajectories);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb Allocations"), STAT_ClimbAllocations, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb Allocated Bytes"), STAT_ClimbAllocatedBytes, STATGROUP_Climbing);
+
+namespace CS_ClimbMemory
+{
+	// 只在游戏线程上记录
+	static FFrameAllocations GCurrentFrame;
+	static FFrameAllocations GLastFrame;
+
+	static void RollFrame()
+	{
+		if (GCurrentFrame.FrameNumber != GFrameCounter)
+		{
+			GLastFrame = GCurrentFrame;
+			GCurrentFrame = FFrameAllocations();
+			GCurrentFrame.FrameNumber = GFrameCounter;
+		}
+	}
+
+	void NoteAllocation(int64 Bytes)
+	{
+		check(IsInGameThread());
+
+		RollFrame();
+		GCurrentFrame.Count++;
+		GCurrentFrame.Bytes += Bytes;
+
+		INC_DWORD_STAT(STAT_ClimbAllocations);
+		INC_DWORD_STAT_BY(STAT_ClimbAllocatedBytes, Bytes);
+	}
+
+	FFrameAllocations GetLastFrameAllocations()
+	{
+		RollFrame();
+		if (GLastFrame.FrameNumber + 1 != GFrameCounter)
+		{
+			// 上一帧没有任何分配
+			FFrameAllocations EmptyFrame;
+			EmptyFrame.FrameNumber = GFrameCounter - 1;
+			return EmptyFrame;
+		}
+		return GLastFrame;
+	}
+}
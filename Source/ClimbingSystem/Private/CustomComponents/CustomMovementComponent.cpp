@@ -5,58 +5,234 @@
 
 #include "MotionWarpingComponent.h"
 #include "Character/CharacterAnimInstance.h"
+#include "AnimNotifies/AnimNotifyState_ClimbWindow.h"
 #include "ClimbingSystem/DebugHelper.h"
 #include "GameFramework/Character.h"
-#include "Kismet/KismetSystemLibrary.h"
 #include "ClimbingSystem/ClimbingSystemCharacter.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/OverlapResult.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Actors/ClimbPathActor.h"
+#include "CustomComponents/ClimbLandscapeQuery.h"
+#include "CustomComponents/ClimbVisualLogger.h"
+#include "CustomComponents/ClimbingMemory.h"
+#include "CustomComponents/ClimbingStats.h"
+#include "LandscapeProxy.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Validation Cheap Accepted"), STAT_ClimbValidationCheapAccepted, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Validation Full Traces"), STAT_ClimbValidationFullTraces, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Validation Rejected"), STAT_ClimbValidationRejected, STATGROUP_Climbing);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bone Body Sweeps"), STAT_ClimbBoneBodySweeps, STATGROUP_Climbing);
+
+static FAutoConsoleCommandWithWorld GClimbMemReportCommand(
+	TEXT("Climb.MemReport"),
+	TEXT("Prints per-character and total climbing memory, shared montage memory and the climbing allocations of the last frame."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		FClimbMemoryUsage TotalUsage;
+		TSet<const UAnimMontage*> Montages;
+		int32 NumCharacters = 0;
+
+		for (TObjectIterator<UCustomMovementComponent> It; It; ++It)
+		{
+			if (It->GetWorld() != World || !It->GetOwner())
+			{
+				continue;
+			}
+
+			FClimbMemoryUsage Usage;
+			It->GetClimbMemoryUsage(Usage);
+			It->GetClimbMontages(Montages);
+
+			UE_LOG(LogTemp, Log, TEXT("%-32s total %8.1f KB  component %6.1f KB  hits %6.1f KB  dash %6.1f KB  distance field %8.1f KB  motion warping %6.1f KB"),
+				*It->GetOwner()->GetName(),
+				Usage.GetTotal() / 1024.f,
+				Usage.ComponentState / 1024.f,
+				Usage.TraceHits / 1024.f,
+				Usage.DashData / 1024.f,
+				Usage.DistanceField / 1024.f,
+				Usage.MotionWarping / 1024.f);
+
+			TotalUsage.ComponentState += Usage.ComponentState;
+			TotalUsage.TraceHits += Usage.TraceHits;
+			TotalUsage.DashData += Usage.DashData;
+			TotalUsage.DistanceField += Usage.DistanceField;
+			TotalUsage.MotionWarping += Usage.MotionWarping;
+			NumCharacters++;
+		}
+
+		SIZE_T MontageBytes = 0;
+		for (const UAnimMontage* Montage : Montages)
+		{
+			MontageBytes += Montage->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+
+		const CS_ClimbMemory::FFrameAllocations LastFrame = CS_ClimbMemory::GetLastFrameAllocations();
+		UE_LOG(LogTemp, Log, TEXT("Climbing characters: %d  per-character total %.1f KB  shared montages (%d): %.1f KB"),
+			NumCharacters, TotalUsage.GetTotal() / 1024.f, Montages.Num(), MontageBytes / 1024.f);
+		UE_LOG(LogTemp, Log, TEXT("Frame %llu: %d climbing allocations, %.1f KB"),
+			LastFrame.FrameNumber, LastFrame.Count, LastFrame.Bytes / 1024.f);
+	}));
+
+static FAutoConsoleCommandWithWorld GClimbTraversalStatsCommand(
+	TEXT("Climb.TraversalStats"),
+	TEXT("Prints per-state residency time and probe counts of every climbing movement component."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TObjectIterator<UCustomMovementComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World && It->GetOwner())
+			{
+				UE_LOG(LogTemp, Log, TEXT("%s\n%s"), *It->GetOwner()->GetName(), *It->GetClimbTraversal().DescribeStats());
+			}
+		}
+	}));
 
 
+template <typename AxisPolicy, typename DebugPolicy>
+FHitResult UCustomMovementComponent::TraceFromEyeHeight(float TraceDistance, float TraceStartOffset) const
+{
+	FVector Start;
+	FVector End;
+	CS_ClimbTrace::GetEyeHeightSegment<AxisPolicy>(*UpdatedComponent, CharacterOwner->BaseEyeHeight + TraceStartOffset, TraceDistance, Start, End);
+
+	FHitResult DistanceFieldHit;
+	if (TraceWithClimbDistanceField(Start, End, DistanceFieldHit))
+	{
+		return DistanceFieldHit;
+	}
+
+	return DoLineTraceSingleByObject<DebugPolicy>(Start, End);
+}
+
+template <typename DebugPolicy>
+TArray<FHitResult> UCustomMovementComponent::DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, bool bReturnPhysicalMaterial) const
+{
+	LLM_SCOPE_BYTAG(Climbing_Probes);
+
+	return CS_ClimbTrace::Trace<DebugPolicy>(ClimbTraceContext, CS_ClimbTrace::FCapsuleMulti(ClimbCapsuleTraceRadius, ClimbCapsuleTraceHalfHeight, bReturnPhysicalMaterial), Start, End);
+}
+
+template <typename DebugPolicy>
+FHitResult UCustomMovementComponent::DoLineTraceSingleByObject(const FVector& Start, const FVector& End) const
+{
+	return CS_ClimbTrace::Trace<DebugPolicy>(ClimbTraceContext, CS_ClimbTrace::FLineSingle(), Start, End);
+}
+
 void UCustomMovementComponent::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(Climbing);
+
 	Super::BeginPlay();
 
 	CharacterAnimInstance = CharacterOwner->GetMesh()->GetAnimInstance();
 
 	if (CharacterAnimInstance)
 	{
-		// 绑定攀爬蒙太奇结束事件
-		CharacterAnimInstance->OnMontageEnded.AddDynamic(this, &UCustomMovementComponent::OnClimbMontageEnded);
-		// 绑定攀爬蒙太奇淡出事件
-		CharacterAnimInstance->OnMontageBlendingOut.AddDynamic(this, &UCustomMovementComponent::OnClimbMontageEnded);
+		// 绑定攀爬蒙太奇淡出事件，没有切换窗口的蒙太奇在淡出时切换移动模式
+		CharacterAnimInstance->OnMontageBlendingOut.AddDynamic(this, &UCustomMovementComponent::OnClimbMontageBlendingOut);
 	}
 
 	ClimbingSystemCharacter = Cast<AClimbingSystemCharacter>(CharacterOwner);
+
+	// 对象类型只转换一次，检测时直接使用
+	ClimbTraceContext.World = GetWorld();
+	ClimbTraceContext.LogOwner = CharacterOwner;
+	ClimbTraceContext.ObjectParams = FCollisionObjectQueryParams(ClimbTraceObjectTypes);
+	ClimbTraceContext.TraceChannel = bUseClimbTraceChannel ? ECC_Climb : ECC_MAX;
+	ClimbTraceContext.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(ClimbTrace), false);
+	ClimbTraceContext.MaterialQueryParams = ClimbTraceContext.QueryParams;
+	ClimbTraceContext.MaterialQueryParams.bReturnPhysicalMaterial = true;	// 只有攀爬表面检测需要物理材质
+
+	ClimbSurfaceMaterials.Initialize(ClimbSurfaceMaterialOverrides, DefaultClimbSurface);
+	CurrentClimbSurface = DefaultClimbSurface;
+
+	{
+		LLM_SCOPE_BYTAG(Climbing_Trajectories);
+		BuildClimbDashDirections();
+		BakeClimbDashTrajectories();
+	}
+
+	ClimbDistanceField.Initialize(ClimbDistanceFieldVoxelSize, ClimbDistanceFieldBrickResolution, ClimbDistanceFieldRadius);
+
+	ClimbTraversal.Initialize(ClimbTraversalStateTable);
+
+	if (bRecordClimbSnapshots)
+	{
+		ClimbSnapshots.Initialize(ClimbSnapshotBufferSize);
+	}
 }
 
 void UCustomMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	ClimbTraceContext.NumTraces = 0;
+	ClimbWorkCycles = 0;
+
+	// 先同步遍历状态，这一帧的检测都按当前状态的描述运行
+	ClimbTraversal.Tick(DeltaTime);
+	ClimbTraversal.SyncState(ResolveClimbTraversalState());
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	// 如果角色移动速度大于0.1f
-	if (Velocity.X > 10.0f || Velocity.Y > 10.f)
+	// 攀爬物理在 PhysCustom 中计时，这里计入 Tick 中的攀爬检测
+	const uint64 ProbeStartCycles = FPlatformTime::Cycles64();
+
+	if (bUseClimbDistanceField && IsClimbing())
 	{
-		if (CharacterAnimInstance->IsAnyMontagePlaying())
-		{
-			// 如果有动画正在播放
-			return;
-		}
+		// 只在攀爬时维护角色周围的距离场
+		UpdateClimbDistanceField();
+	}
 
-		if (CanStartClimbing())
-		{
-			// Start climbing
-			PlayClimbMontage(AnimMontage_StandToWallUp);
-		}
-		else if (CanClimbDownLedge())
-		{
-			// 如果可以下爬，播放下爬蒙太奇
-			PlayClimbMontage(AnimMontage_ClimbToDown);
-		}
-		else
-		{
-			TryStartVaulting();
-		}
+	if (bPendingClimbCapsuleRestore && !IsClimbing())
+	{
+		// 离开攀爬时胶囊体被阻挡，空间足够后再恢复
+		TryRestoreClimbCapsule();
+	}
+
+	if (WallJumpTarget.bValid && ClimbTraversal.WantsProbe(EClimbProbe::WallRegrab))
+	{
+		// 蹬墙跳在空中时使用求解的落点重新抓墙
+		TickWallJumpRegrab();
+	}
+
+	// 只有接近状态（地面移动且没有蒙太奇）声明了这些检测
+	// 服务器上远程控制的角色由客户端声明上墙和翻越，不在服务器上重复检测
+	const bool bAwaitingClaims = IsAwaitingClimbMoveClaims();
+	if (!bAwaitingClaims && ClimbTraversal.WantsProbe(EClimbProbe::StartClimb) && CanStartClimbing())
+	{
+		// Start climbing
+		PlayClimbMontage(AnimMontage_StandToWallUp);
+		SendClimbMoveClaim(MakeStartClimbClaim());
+		RecordClimbTelemetry(EClimbTelemetryEvent::ClimbStart);
+	}
+	else if (ClimbTraversal.WantsProbe(EClimbProbe::ClimbDownLedge) && CanClimbDownLedge())
+	{
+		// 如果可以下爬，播放下爬蒙太奇
+		PlayClimbMontage(AnimMontage_ClimbToDown);
+	}
+	else if (!bAwaitingClaims && ClimbTraversal.WantsProbe(EClimbProbe::Vault))
+	{
+		TryStartVaulting();
+	}
+
+	ClimbWorkCycles += FPlatformTime::Cycles64() - ProbeStartCycles;
+
+	if (bRecordClimbSnapshots)
+	{
+		RecordClimbSnapshot(DeltaTime);
+	}
+
+	LastFrameClimbTraces = ClimbTraceContext.NumTraces;
+
+	if (ClimbTraceContext.NumTraces > 0 && CS_ClimbTelemetry::IsEnabled())
+	{
+		// 只记录有检测的帧
+		const float CostMicroseconds = FPlatformTime::ToMilliseconds64(ClimbWorkCycles) * 1000.f;
+		CS_ClimbTelemetry::Record(GetWorld(), EClimbTelemetryEvent::FrameCost, UpdatedComponent->GetComponentLocation(),
+			static_cast<uint16>(FMath::Min<uint32>(ClimbTraceContext.NumTraces, MAX_uint16)), CostMicroseconds);
 	}
 	
 }
@@ -66,12 +242,24 @@ void UCustomMovementComponent::ToggleClimbingMode(bool bEnableClimb)
 	if (bEnableClimb)
 	{
 		// Enable climbing mode
+		if (TryStartClimbPath())
+		{
+			// 优先抓住附近的攀爬路径
+			return;
+		}
+
 		if (CanStartClimbing())
 		{
 			// Start climbing
 			PlayClimbMontage(AnimMontage_StandToWallUp);
+			SendClimbMoveClaim(MakeStartClimbClaim());
+			RecordClimbTelemetry(EClimbTelemetryEvent::ClimbStart);
+			return;
 		}
-		else if (CanClimbDownLedge())
+
+		RecordClimbTelemetry(EClimbTelemetryEvent::ClimbStartFailed);
+
+		if (CanClimbDownLedge())
 		{
 			// 如果可以下爬，播放下爬蒙太奇
 			PlayClimbMontage(AnimMontage_ClimbToDown);
@@ -84,7 +272,14 @@ void UCustomMovementComponent::ToggleClimbingMode(bool bEnableClimb)
 	else
 	{
 		// Disable climbing mode
-		StopClimbing();
+		if (IsOnClimbPath())
+		{
+			StopClimbPath();
+		}
+		else
+		{
+			StopClimbing();
+		}
 	}
 }
 
@@ -94,15 +289,31 @@ bool UCustomMovementComponent::IsClimbing() const
 	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::MOVE_Climb;
 }
 
+bool UCustomMovementComponent::IsOnClimbPath() const
+{
+	return MovementMode == MOVE_Custom
+		&& (CustomMovementMode == ECustomMovementMode::MOVE_Ladder
+			|| CustomMovementMode == ECustomMovementMode::MOVE_Rope
+			|| CustomMovementMode == ECustomMovementMode::MOVE_Pipe
+			|| CustomMovementMode == ECustomMovementMode::MOVE_Zipline);
+}
+
+bool UCustomMovementComponent::IsLedgeHanging() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == ECustomMovementMode::MOVE_LedgeHang;
+}
+
 bool UCustomMovementComponent::CanStartClimbing()
 {
+	CLIMB_VLOG_PROBE_SCOPE("StartClimb");
+
 	if (IsFalling())
 	{
 		// 如果角色正在下落，不允许开始攀爬
 		return false;
 	}
 
-	if (IsClimbing())
+	if (IsClimbing() || IsOnClimbPath() || IsLedgeHanging())
 	{
 		// 如果角色正在攀爬，不允许开始攀爬
 		return false;
@@ -126,6 +337,8 @@ bool UCustomMovementComponent::CanStartClimbing()
 
 bool UCustomMovementComponent::CanClimbDownLedge() const
 {
+	CLIMB_VLOG_PROBE_SCOPE("ClimbDownLedge");
+
 	if (IsFalling())
 	{
 		// 如果角色正在下落，不允许下爬
@@ -147,12 +360,12 @@ bool UCustomMovementComponent::CanClimbDownLedge() const
 	const FVector WalkableSurfaceTraceStart = ComponentLocation + ComponentForward * ClimbDownWalkableSurfaceTraceOffset;
 	const FVector WalkableSurfaceTraceEnd = WalkableSurfaceTraceStart + DownVector * 100.f;
 
-	FHitResult WalkableSurfaceHitResult = DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd, false, false);
+	FHitResult WalkableSurfaceHitResult = DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd);
 
 	const FVector LedgeTraceStart = WalkableSurfaceHitResult.TraceStart + ComponentForward * ClimbDownLedgeTraceOffset;
 	const FVector LedgeTraceEnd = LedgeTraceStart + DownVector * 300.f;
 
-	FHitResult LedgeTraceHitResult = DoLineTraceSingleByObject(LedgeTraceStart, LedgeTraceEnd, false, false);
+	FHitResult LedgeTraceHitResult = DoLineTraceSingleByObject(LedgeTraceStart, LedgeTraceEnd);
 
 	if (WalkableSurfaceHitResult.bBlockingHit && !LedgeTraceHitResult.bBlockingHit)
 	{
@@ -184,17 +397,48 @@ void UCustomMovementComponent::PhysClimb(float DeltaTime, int32 Iterations)
 		return;
 	}
 
-	// 处理攀爬表面
-	TraceClimbableSurface();
-	ProcessClimbableSurfaceInfo();
+	if (IsInCornerTransition())
+	{
+		// 墙角过渡期间沿解析路径移动，不做任何表面检测
+		PhysClimbCornerTransition(DeltaTime);
+		return;
+	}
+
+	// 处理攀爬表面：角色相对基座没有移动时，直接用基座的变换还原表面，不重新检测
+	// 没有表面缓存或者没有基座时无法还原，不管遍历状态是否声明了检测都必须检测（例如蒙太奇切换窗口中提前进入攀爬）
+	const bool bMustProbeSurface = !bHasClimbSurfaceBaseCache || !CharacterOwner->GetMovementBase();
+	const bool bReprobeSurface = bMustProbeSurface || (ShouldReprobeClimbSurface() && ClimbTraversal.WantsProbe(EClimbProbe::ClimbableSurface));
+	if (bReprobeSurface)
+	{
+		TraceClimbableSurface();
+		ProcessClimbableSurfaceInfo();
+		UpdateClimbSurfaceBase();
+	}
+	else
+	{
+		RefreshClimbSurfaceFromBase();
+	}
+
+	// 横向移动到墙角时，一次性查询相邻墙面并开始墙角过渡，而不是掉下去或在两个面之间来回抖动
+	if (bReprobeSurface && ShouldProbeCorner() && ClimbTraversal.WantsProbe(EClimbProbe::Corner) && TryStartCornerTransition())
+	{
+		PhysClimbCornerTransition(DeltaTime);
+		return;
+	}
 
-	// 检测是否应该攀爬
-	if (!CheckShouldClimb() || CheckReachableGround())
+	// 检测是否应该攀爬（到达地面需要角色相对基座向下移动，没有重新检测时不需要判断）
+	if (!CheckShouldClimb() || (bReprobeSurface && ClimbTraversal.WantsProbe(EClimbProbe::ReachableGround) && CheckReachableGround()))
 	{
 		// 如果不应该攀爬，停止攀爬
 		// 如果到达地面，停止攀爬
 		StopClimbing();
 	}
+	else if (UpdateClimbGrip(DeltaTime))
+	{
+		// 在湿滑表面上抓握时间耗尽，脱手
+		StopClimbing();
+		RecordClimbTelemetry(EClimbTelemetryEvent::GripLost);
+	}
 
 	RestorePreAdditiveRootMotionVelocity();
 
@@ -228,11 +472,18 @@ void UCustomMovementComponent::PhysClimb(float DeltaTime, int32 Iterations)
 	// 将角色移动固定到攀爬表面
 	SnapMovementToClimbableSurface(DeltaTime);
 
-	// 
-	if (CheckReachedLedge())
+	// 到达顶端同样需要角色相对基座向上移动
+	FHitResult LedgeTopHit;
+	const bool bPredictTopOut = bEnableTopOutPrediction && !CanUseLandscapeFastPath();
+	if (bReprobeSurface && ClimbTraversal.WantsProbe(EClimbProbe::TopOut)
+		&& (bPredictTopOut ? CheckPredictedLedge(LedgeTopHit) : CheckReachedLedge(LedgeTopHit)))
 	{
-		// 如果到达攀爬顶端，播放下墙蒙太奇
-		PlayClimbMontage(AnimMontage_ClimbToTop);
+		// 如果到达攀爬顶端，先挂在边缘上，不能挂边时直接播放上墙蒙太奇
+		if (!bEnableLedgeHang || !TryStartLedgeHang(LedgeTopHit))
+		{
+			PlayClimbMontage(AnimMontage_ClimbToTop);
+			RecordClimbTelemetry(EClimbTelemetryEvent::TopOut);
+		}
 	}
 	
 }
@@ -252,8 +503,13 @@ bool UCustomMovementComponent::CheckShouldClimb() const
 	//	return false;
 	//}
 
-	// 计算当前攀爬表面法线和上向量的点积，然后计算角度差
-	const float DotResult = FVector::DotProduct(CurrentClimbableSurfaceNormal, FVector::UpVector);
+	return IsClimbableSurfaceNormal(CurrentClimbableSurfaceNormal);
+}
+
+bool UCustomMovementComponent::IsClimbableSurfaceNormal(const FVector& SurfaceNormal) const
+{
+	// 计算攀爬表面法线和上向量的点积，然后计算角度差
+	const float DotResult = FVector::DotProduct(SurfaceNormal, FVector::UpVector);
 	const float DegreeDifference = FMath::RadiansToDegrees(FMath::Acos(DotResult));		// 计算角度差
 
 	if (DegreeDifference <= 60.f)
@@ -267,6 +523,13 @@ bool UCustomMovementComponent::CheckShouldClimb() const
 
 bool UCustomMovementComponent::CheckReachableGround() const
 {
+	CLIMB_VLOG_PROBE_SCOPE("ReachableGround");
+
+	if (CanUseLandscapeFastPath())
+	{
+		return CheckReachableLandscapeGround();
+	}
+
 	// 检测是否到达地面
 	const FVector DownVector = -UpdatedComponent->GetUpVector();
 	const FVector StartOffset = DownVector * 50.0f;
@@ -274,7 +537,7 @@ bool UCustomMovementComponent::CheckReachableGround() const
 	const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
 	const FVector End = Start + DownVector;
 
-	TArray<FHitResult> HitResults = DoCapsuleTraceMultiByObject(Start, End, false, false);
+	TArray<FHitResult> HitResults = DoCapsuleTraceMultiByObject(Start, End);
 
 	if (HitResults.IsEmpty())
 	{
@@ -295,8 +558,15 @@ bool UCustomMovementComponent::CheckReachableGround() const
 
 }
 
-bool UCustomMovementComponent::CheckReachedLedge() const
+bool UCustomMovementComponent::CheckReachedLedge(FHitResult& OutLedgeTopHit) const
 {
+	CLIMB_VLOG_PROBE_SCOPE("ReachedLedge");
+
+	if (CanUseLandscapeFastPath())
+	{
+		return CheckReachedLandscapeLedge(OutLedgeTopHit);
+	}
+
 	// 检测是否到达攀爬顶端
 	FHitResult EyeHeightHitResult = TraceFromEyeHeight(100.f, ClimbToTopTraceDistance);		// 从眼睛高度上方50.f开始检测
 
@@ -311,12 +581,13 @@ bool UCustomMovementComponent::CheckReachedLedge() const
 	const FVector DownVector = -UpdatedComponent->GetUpVector();
 	const FVector WalkableSurfaceTraceEnd = WalkableSurfaceTraceStart + DownVector * 100.f;
 
-	FHitResult WalkableSurfaceHitResult = DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd, false, false);
+	FHitResult WalkableSurfaceHitResult = DoLineTraceSingleByObject(WalkableSurfaceTraceStart, WalkableSurfaceTraceEnd);
 
 	if (WalkableSurfaceHitResult.bBlockingHit && GetUnRotatedClimbVelocity().Z > 10.f)
 	{
 		// 如果检测到阻挡，说明到达了攀爬顶端，并且前方100.f的位置有地面，返回true
 		// 并且速度大于10.f，表明角色正在向上攀爬
+		OutLedgeTopHit = WalkableSurfaceHitResult;
 		return true;
 	}
 
@@ -341,9 +612,21 @@ void UCustomMovementComponent::ProcessClimbableSurfaceInfo()
 	
 	CurrentClimbableSurfaceNormal = CurrentClimbableSurfaceNormal.GetSafeNormal();
 
-	//// Debug
-	//UKismetSystemLibrary::DrawDebugSphere(this, CurrentClimbableSurfaceLocation, 10.f, 12, FColor::Green, 0.1f, 1.0f);
-	//UKismetSystemLibrary::DrawDebugArrow(this, CurrentClimbableSurfaceLocation, CurrentClimbableSurfaceLocation + CurrentClimbableSurfaceNormal * 100.f, 10.f, FColor::Green, 0.1f, 1.0f);
+	// 记录命中法线的分散程度，分散过大说明胶囊体同时扫到了墙角两侧的面
+	ClimbableSurfaceNormalSpread = 1.f;
+	for (const FHitResult& Hit : ClimbableSurfaceTraceHits)
+	{
+		ClimbableSurfaceNormalSpread = FMath::Min(ClimbableSurfaceNormalSpread, FVector::DotProduct(Hit.ImpactNormal, CurrentClimbableSurfaceNormal));
+	}
+
+	if (!CurrentClimbableSurfaceNormal.IsNearlyZero())
+	{
+		LastValidClimbableSurfaceLocation = CurrentClimbableSurfaceLocation;
+		LastValidClimbableSurfaceNormal = CurrentClimbableSurfaceNormal;
+	}
+
+	// 拟合出的攀爬表面
+	CLIMB_VLOG_SURFACE(CharacterOwner, "ClimbableSurface", CurrentClimbableSurfaceLocation, CurrentClimbableSurfaceNormal);
 
 }
 
@@ -377,8 +660,8 @@ void UCustomMovementComponent::SnapMovementToClimbableSurface(float DeltaTime)
 	// 计算角色面向攀爬表面的投影向量(投影到角色面向)
 	const FVector SnapVector = -CurrentClimbableSurfaceNormal * ProjectedCharacterToSurface.Length();
 
-	// 绘制 SnapVector
-	// UKismetSystemLibrary::DrawDebugArrow(this, ComponentLocation, ComponentLocation + SnapVector, 10.f, FColor::Green, 0.1f, 1.0f);
+	// 记录 SnapVector
+	CLIMB_VLOG_SEGMENT(CharacterOwner, "Snap", ComponentLocation, ComponentLocation + SnapVector, FColor::Yellow);
 
 	UpdatedComponent->MoveComponent(
 		SnapVector*DeltaTime*MaxClimbSpeed,
@@ -386,478 +669,2758 @@ void UCustomMovementComponent::SnapMovementToClimbableSurface(float DeltaTime)
 		true);
 }
 
-FVector UCustomMovementComponent::GetUnRotatedClimbVelocity() const
-{
-	// 获取未旋转的攀爬速度（因为四元数旋转的特性，所以要对速度进行反旋转，就能得到未旋转的速度）
-	return UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), Velocity);
-}
-
-void UCustomMovementComponent::ClimbDash()
+bool UCustomMovementComponent::ShouldProbeCorner() const
 {
-	// 攀爬冲刺
-	if (IsClimbing())
+	if (!bEnableCornerWrapping || HasAnimRootMotion() || CurrentRootMotion.HasOverrideVelocity())
 	{
-		const FVector LastInputVector = GetLastInputVector().GetSafeNormal();
-		// 获取最后一次输入向量，并对其进行反旋转，得到未旋转的输入向量，用于后续角色跳跃的方向判定
-		// const FVector UnRotatedLastInputVector = UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), LastInputVector).GetSafeNormal();
-
-		// 获取角色右向量
-		const FVector RightVector = UpdatedComponent->GetRightVector().GetSafeNormal();
-		// 获取角色上向量
-		const FVector UpVector = UpdatedComponent->GetUpVector().GetSafeNormal();
-		
-		// UKismetSystemLibrary::DrawDebugArrow(this, UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + LastInputVector * 200, 10.f, FColor::Red, 1.1f, 1.0f);
-		// UKismetSystemLibrary::DrawDebugArrow(this, UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + UnRotatedLastInputVector * 150.f, 10.f, FColor::Green, 1.1f, 1.0f);
-		// UKismetSystemLibrary::DrawDebugArrow(this, UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + RightVector * 100.f, 10.f, FColor::Blue, 1.1f, 1.0f);
-		// UKismetSystemLibrary::DrawDebugArrow(this, UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + UpVector * 100.f, 10.f, FColor::Yellow, 1.1f, 1.0f);
-
-		const float DotResult_Z = FVector::DotProduct(LastInputVector, UpVector);
-		// CS_Debug::Print("DotResult_Z: " + FString::SanitizeFloat(DotResult_Z));
-
-		// const float AngleDifference = FMath::RadiansToDegrees(FMath::Acos(DotResult_Z));
-		// CS_Debug::Print("AngleDifference: " + FString::SanitizeFloat(AngleDifference));
-
-		if (DotResult_Z >= 0.9f)
-		{
-			// 如果输入向量与上向量的点积大于等于0.9f，表明角色正在向上攀爬
-			HandleClimbDashUp();
-		}
-		else if (DotResult_Z <= -0.9f)
-		{
-			// 如果输入向量与上向量的点积小于等于-0.9f，表明角色正在向下攀爬
-			HandleClimbDashDown();
-		}
-		else
-		{
-			// 计算和角色右向量的点积
-			const float DotResult_X = FVector::DotProduct(LastInputVector, RightVector);
-			// CS_Debug::Print("DotResult_X: " + FString::SanitizeFloat(DotResult_X));
+		return false;
+	}
 
-			if (DotResult_X >= 0.9f)
-			{
-				// 如果输入向量与右向量的点积大于等于0.9f，表明角色正在向右攀爬
-				HandleClimbDashRight();
-			}
-			else if (DotResult_X <= -0.9f)
-			{
-				// 如果输入向量与右向量的点积小于等于-0.9f，表明角色正在向左攀爬
-				HandleClimbDashLeft();
-			}
-		}
+	if (LastValidClimbableSurfaceNormal.IsNearlyZero())
+	{
+		// 还没有任何有效的攀爬表面，无法判断墙角
+		return false;
+	}
 
-		
+	if (FMath::Abs(GetUnRotatedClimbVelocity().Y) < 10.f)
+	{
+		// 只有横向移动时才会到达墙角
+		return false;
 	}
-}
 
-void UCustomMovementComponent::OnClimbMontageEnded(UAnimMontage* Montage, bool bBInterrupted)
-{
-	// 攀爬蒙太奇结束
-	if (Montage == AnimMontage_StandToWallUp 
-		|| Montage == AnimMontage_ClimbToDown 
-		|| Montage == AnimMontage_ClimbDashUp
-		|| Montage == AnimMontage_ClimbDashDown
-		|| Montage == AnimMontage_ClimbDashLeft
-		|| Montage == AnimMontage_ClimbDashRight)
+	if (bHasFailedCornerProbe && FVector::DistSquared(UpdatedComponent->GetComponentLocation(), LastFailedCornerProbeLocation) < FMath::Square(CornerProbeRetryDistance))
 	{
-		if (!bBInterrupted)
-		{
-			// 如果是上墙蒙太奇被打断，不继续攀爬
-			StartClimbing();
-		}
+		// 在上次检测失败的位置附近，不重复检测
+		return false;
 	}
-	else if (Montage == AnimMontage_ClimbToTop || Montage == AnimMontage_Vaulting)
+
+	if (ClimbableSurfaceTraceHits.IsEmpty() || !CheckShouldClimb())
 	{
-		// 如果是上到顶端蒙太奇结束
-		SetMovementMode(MOVE_Walking);
+		// 表面丢失或者法线退化（外墙角）
+		return true;
 	}
+
+	// 命中法线分散过大（内墙角或者外墙角的棱线）
+	return ClimbableSurfaceNormalSpread < FMath::Cos(FMath::DegreesToRadians(CornerNormalSpreadAngle));
 }
 
-void UCustomMovementComponent::PlayClimbMontage(UAnimMontage* MontageToPlay)
+bool UCustomMovementComponent::TryStartCornerTransition()
 {
-	if (CharacterAnimInstance && MontageToPlay)
+	const float LateralSpeed = GetUnRotatedClimbVelocity().Y;
+	const FVector MoveDirection = UpdatedComponent->GetRightVector() * FMath::Sign(LateralSpeed);
+
+	EClimbCornerType CornerType = EClimbCornerType::None;
+	FHitResult AdjacentHit;
+
+	if (ProbeAdjacentCornerFace(MoveDirection, CornerType, AdjacentHit)
+		&& ComputeCornerTransition(CornerType, AdjacentHit.ImpactPoint, AdjacentHit.ImpactNormal))
 	{
-		if (CharacterAnimInstance->Montage_IsPlaying(MontageToPlay))
-		{
-			// 如果动画正在播放，不重复播放
-			return;
-		}
-		if (CharacterAnimInstance->IsAnyMontagePlaying())
-		{
-			// 如果有动画正在播放，停止播放
-			return;
-		}
-		
-		CharacterAnimInstance->Montage_Play(MontageToPlay);
+		CLIMB_VLOG_SURFACE(CharacterOwner, "CornerTarget", AdjacentHit.ImpactPoint, AdjacentHit.ImpactNormal);
+		CLIMB_VLOG_LOCATION(CharacterOwner, "CornerPivot", CornerTransition.Pivot, FColor::Purple);
+		bHasFailedCornerProbe = false;
+		return true;
 	}
+
+	// 记录失败位置，离开一定距离之前不再检测
+	bHasFailedCornerProbe = true;
+	LastFailedCornerProbeLocation = UpdatedComponent->GetComponentLocation();
+	return false;
 }
 
-void UCustomMovementComponent::TryStartVaulting()
+bool UCustomMovementComponent::ProbeAdjacentCornerFace(const FVector& MoveDirection, EClimbCornerType& OutCornerType, FHitResult& OutAdjacentHit) const
 {
-	FVector VaultStartLocation = FVector::ZeroVector;
-	FVector VaultLandLocation = FVector::ZeroVector;
-	if (CanStartVaulting(VaultStartLocation, VaultLandLocation))
+	CLIMB_VLOG_PROBE_SCOPE("Corner");
+
+	OutCornerType = EClimbCornerType::None;
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector WallNormal = LastValidClimbableSurfaceNormal;
+	const float WallDistance = FMath::Max(FVector::DotProduct(ComponentLocation - LastValidClimbableSurfaceLocation, WallNormal), 0.f);
+
+	// 内墙角：沿移动方向检测，前方有一面朝向角色的墙
+	const FVector InnerStart = ComponentLocation;
+	const FVector InnerEnd = InnerStart + MoveDirection * CornerProbeDistance;
+	FHitResult InnerHit = DoLineTraceSingleByObject(InnerStart, InnerEnd);
+
+	if (InnerHit.bBlockingHit
+		&& FVector::DotProduct(InnerHit.ImpactNormal, MoveDirection) < -0.5f
+		&& IsClimbableSurfaceNormal(InnerHit.ImpactNormal))
 	{
-		// 如果可以开始翻越
-		// Start vaulting
-		// UKismetSystemLibrary::DrawDebugSphere(this, VaultStartLocation, 10.f, 12, FColor::Green, 0.1f, 1.0f);
-		// UKismetSystemLibrary::DrawDebugSphere(this, VaultLandLocation, 10.f, 12, FColor::Blue, 0.1f, 1.0f);
+		OutCornerType = EClimbCornerType::Inner;
+		OutAdjacentHit = InnerHit;
+		return true;
+	}
 
-		SetMotionWarpingTarget("VaultStartPoint", VaultStartLocation);
-		SetMotionWarpingTarget("VaultEndPoint", VaultLandLocation);
+	// 外墙角：从棱线外侧、当前墙面后方往回检测，命中的面朝向移动方向
+	const FVector OuterStart = ComponentLocation - WallNormal * (WallDistance + CornerProbeDistance * 0.5f) + MoveDirection * CornerProbeDistance;
+	const FVector OuterEnd = OuterStart - MoveDirection * CornerProbeDistance * 2.f;
+	FHitResult OuterHit = DoLineTraceSingleByObject(OuterStart, OuterEnd);
 
-		StartClimbing();
-		PlayClimbMontage(AnimMontage_Vaulting);
+	if (OuterHit.bBlockingHit
+		&& FVector::DotProduct(OuterHit.ImpactNormal, MoveDirection) > 0.5f
+		&& IsClimbableSurfaceNormal(OuterHit.ImpactNormal))
+	{
+		OutCornerType = EClimbCornerType::Outer;
+		OutAdjacentHit = OuterHit;
+		return true;
 	}
+
+	return false;
 }
 
-bool UCustomMovementComponent::CanStartVaulting(FVector& OutVaultStartLocation, FVector& OutVaultLandLocation) const
+bool UCustomMovementComponent::ComputeCornerTransition(EClimbCornerType CornerType, const FVector& AdjacentLocation, const FVector& AdjacentNormal)
 {
-	if (IsClimbing())
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+
+	// 只在水平面内计算，墙角棱线视为竖直
+	const FVector N0 = LastValidClimbableSurfaceNormal.GetSafeNormal2D();
+	const FVector N1 = AdjacentNormal.GetSafeNormal2D();
+
+	// 两个墙面的交线（棱线）：解二元一次方程组 N0·X = N0·S0, N1·X = N1·S1
+	const float Det = N0.X * N1.Y - N0.Y * N1.X;
+	if (FMath::Abs(Det) < 0.1f)
 	{
-		// 如果正在攀爬，不允许翻越
+		// 两个面几乎平行，不是墙角
 		return false;
 	}
-	if (IsFalling())
+
+	const float D0 = N0.X * LastValidClimbableSurfaceLocation.X + N0.Y * LastValidClimbableSurfaceLocation.Y;
+	const float D1 = N1.X * AdjacentLocation.X + N1.Y * AdjacentLocation.Y;
+	const FVector Pivot((D0 * N1.Y - D1 * N0.Y) / Det, (N0.X * D1 - N1.X * D0) / Det, ComponentLocation.Z);
+
+	// 保持和当前墙面相同的贴墙距离
+	const float WallDistance = FMath::Max(FVector::DotProduct(ComponentLocation - LastValidClimbableSurfaceLocation, LastValidClimbableSurfaceNormal), 0.f);
+
+	// 终点在相邻墙面上离开棱线的方向：外墙角绕到旧墙面后方，内墙角离开旧墙面
+	const FVector AwayFromEdge = CornerType == EClimbCornerType::Outer ? -N0 : N0;
+	const FVector ExitDirection = FVector::VectorPlaneProject(AwayFromEdge, N1).GetSafeNormal();
+	if (ExitDirection.IsNearlyZero())
 	{
-		// 如果正在下落，不允许翻越
 		return false;
 	}
 
-	if (TraceFromEyeHeight(100.f).bBlockingHit)
+	FClimbCornerTransition NewTransition;
+	NewTransition.bActive = true;
+	NewTransition.CornerType = CornerType;
+	NewTransition.Pivot = Pivot;
+	NewTransition.StartOffset = FVector(ComponentLocation.X - Pivot.X, ComponentLocation.Y - Pivot.Y, 0.f);
+	NewTransition.EndOffset = N1 * WallDistance + ExitDirection * CornerExitDistance;
+
+	const FVector StartDirection = NewTransition.StartOffset.GetSafeNormal();
+	const FVector EndDirection = NewTransition.EndOffset.GetSafeNormal();
+	if (StartDirection.IsNearlyZero() || EndDirection.IsNearlyZero())
 	{
-		// 如果当前视线高度100.f位置有阻挡，不允许翻越
 		return false;
 	}
 
-	OutVaultStartLocation = FVector::ZeroVector;
-	OutVaultLandLocation = FVector::ZeroVector;
+	// 带符号的最短旋转角
+	const float CrossZ = FVector::CrossProduct(StartDirection, EndDirection).Z;
+	NewTransition.SweepAngle = FMath::Atan2(CrossZ, FVector::DotProduct(StartDirection, EndDirection));
 
-	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
-	const FVector UpVector = UpdatedComponent->GetUpVector();
-	const FVector DownVector = -UpVector;
+	NewTransition.StartRotation = UpdatedComponent->GetComponentQuat();
+	NewTransition.EndRotation = FRotationMatrix::MakeFromX(-AdjacentNormal).ToQuat();
+	NewTransition.EndSurfaceLocation = AdjacentLocation;
+	NewTransition.EndSurfaceNormal = AdjacentNormal;
 
-	for (int32 i = 0; i < 5; i++)
-	{
-		const FVector Start = ComponentLocation + ComponentForward * 100.f * (i+1) + UpVector * 100.f;
-		const FVector End = Start + DownVector * 100.f * (i+1);
+	// 按弧长和攀爬速度估算时长
+	const float AverageRadius = (NewTransition.StartOffset.Size() + NewTransition.EndOffset.Size()) * 0.5f;
+	const float ArcLength = FMath::Abs(NewTransition.SweepAngle) * AverageRadius;
+	// 时长用作插值的除数，不能为0
+	NewTransition.Duration = FMath::Max3(ArcLength / FMath::Max(MaxClimbSpeed, KINDA_SMALL_NUMBER), MinCornerTransitionTime, KINDA_SMALL_NUMBER);
 
-		FHitResult HitResult = DoLineTraceSingleByObject(Start, End, false, false);
+	CornerTransition = NewTransition;
+	return true;
+}
 
-		if (i == 0 && HitResult.bBlockingHit)
-		{
-			// 如果第一次检测到阻挡，说明角色前方0位置可以作为翻越起点
-			OutVaultStartLocation = HitResult.ImpactPoint;
-		}
+void UCustomMovementComponent::PhysClimbCornerTransition(float DeltaTime)
+{
+	CornerTransition.Elapsed = FMath::Min(CornerTransition.Elapsed + DeltaTime, CornerTransition.Duration);
+	const float Alpha = CornerTransition.Elapsed / CornerTransition.Duration;
 
-		if (i == 3 && HitResult.bBlockingHit)
-		{
-			// 如果第五次检测到阻挡，说明角色前方100位置可以作为翻越终点
-			OutVaultLandLocation = HitResult.ImpactPoint;
-		}
+	// 沿棱线做圆弧插值，半径线性过渡
+	const FQuat ArcRotation(FVector::UpVector, CornerTransition.SweepAngle * Alpha);
+	const float Radius = FMath::Lerp(CornerTransition.StartOffset.Size(), CornerTransition.EndOffset.Size(), Alpha);
+	const FVector TargetLocation = CornerTransition.Pivot + ArcRotation.RotateVector(CornerTransition.StartOffset.GetSafeNormal()) * Radius;
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector Delta = FVector(TargetLocation.X - OldLocation.X, TargetLocation.Y - OldLocation.Y, 0.f);
+	const FQuat TargetRotation = FQuat::Slerp(CornerTransition.StartRotation, CornerTransition.EndRotation, Alpha);
+
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(Delta, TargetRotation, true, Hit);
+
+	if (Hit.Time < 1.f)
+	{
+		// 路径被挡住，放弃过渡，回到普通攀爬
+		EndCornerTransition(false);
+		return;
+	}
+
+	Velocity = Delta / DeltaTime;
+
+	if (Alpha >= 1.f)
+	{
+		EndCornerTransition(true);
+	}
+}
+
+void UCustomMovementComponent::EndCornerTransition(bool bReachedTarget)
+{
+	if (bReachedTarget)
+	{
+		// 直接使用过渡时已经查询到的相邻墙面，下一帧的表面检测会继续修正
+		CurrentClimbableSurfaceLocation = CornerTransition.EndSurfaceLocation;
+		CurrentClimbableSurfaceNormal = CornerTransition.EndSurfaceNormal;
+		LastValidClimbableSurfaceLocation = CurrentClimbableSurfaceLocation;
+		LastValidClimbableSurfaceNormal = CurrentClimbableSurfaceNormal;
+	}
+	else
+	{
+		bHasFailedCornerProbe = true;
+		LastFailedCornerProbeLocation = UpdatedComponent->GetComponentLocation();
+	}
+
+	CornerTransition = FClimbCornerTransition();
+	InvalidateClimbSurfaceBase();
+}
+
+void UCustomMovementComponent::ShrinkClimbCapsule()
+{
+	bPendingClimbCapsuleRestore = false;
+
+	// 缩小不会产生新的阻挡或重叠，不需要检测；重叠留到攀爬的下一次移动时刷新
+	CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(CharacterCapsuleHalfHeight / 2.f, false);
+}
+
+bool UCustomMovementComponent::TryRestoreClimbCapsule()
+{
+	UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+
+	// 重置角色旋转，只保留Yaw旋转，Pitch和Roll重置为0，因为在攀爬模式下，角色的Pitch和Roll会因为身体紧贴墙面导致发生变化
+	const FQuat OldRotation = UpdatedComponent->GetComponentQuat();
+	const FQuat CleanRotation = FRotator(0.f, UpdatedComponent->GetComponentRotation().Yaw, 0.f).Quaternion();
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	FVector NewLocation = OldLocation;
+	const bool bCanRestore = FindClimbCapsuleRestoreLocation(CharacterCapsuleHalfHeight, CleanRotation, NewLocation);
+	const bool bTransformChanged = !NewLocation.Equals(OldLocation) || !CleanRotation.Equals(OldRotation);
+
+	{
+		// 形状和变换一起提交，子组件的变换和重叠在作用域结束时只更新一次
+		FScopedMovementUpdate ScopedCapsuleUpdate(UpdatedComponent, EScopedUpdate::DeferredUpdates);
+
+		if (bCanRestore)
+		{
+			Capsule->SetCapsuleHalfHeight(CharacterCapsuleHalfHeight, false);
+		}
+		UpdatedComponent->SetWorldLocationAndRotation(NewLocation, CleanRotation, false, nullptr, ETeleportType::None);
+	}
+
+	if (bCanRestore && !bTransformChanged)
+	{
+		// 变大可能产生新的重叠，变换没有改变时作用域不会刷新重叠
+		Capsule->UpdateOverlaps();
+	}
+
+	bPendingClimbCapsuleRestore = !bCanRestore;
+	return bCanRestore;
+}
+
+bool UCustomMovementComponent::FindClimbCapsuleRestoreLocation(float TargetHalfHeight, const FQuat& TargetRotation, FVector& OutLocation) const
+{
+	const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	const float ScaledTargetHalfHeight = TargetHalfHeight * Capsule->GetShapeScale();
+	const float HeightDelta = ScaledTargetHalfHeight - Capsule->GetScaledCapsuleHalfHeight();
+
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	OutLocation = Location;
+	if (HeightDelta <= 0.f)
+	{
+		return true;
+	}
+
+	// 在保持底部不动和保持顶部不动的两个位置之间扫描，路径上没有阻挡的部分都可以放下变大后的胶囊体
+	const FVector UpVector = TargetRotation.GetUpVector();
+	const FVector Start = Location + UpVector * HeightDelta;
+	const FVector End = Location - UpVector * HeightDelta;
+
+	FCollisionQueryParams CapsuleParams(SCENE_QUERY_STAT(ClimbCapsuleRestore), false, CharacterOwner);
+	FCollisionResponseParams ResponseParams;
+	InitCollisionParams(CapsuleParams, ResponseParams);
+
+	const FCollisionShape TargetShape = FCollisionShape::MakeCapsule(Capsule->GetScaledCapsuleRadius(), ScaledTargetHalfHeight);
+
+	// 沿一个方向扫描，起点没有穿透时返回 true 并给出离原来的中心最近的可用位置
+	auto SweepForRestoreLocation = [&](const FVector& SweepStart, const FVector& SweepEnd)
+	{
+		FHitResult Hit;
+		if (!GetWorld()->SweepSingleByChannel(Hit, SweepStart, SweepEnd, TargetRotation, UpdatedComponent->GetCollisionObjectType(), TargetShape, CapsuleParams, ResponseParams))
+		{
+			// 整条路径都没有阻挡，中心保持不变
+			return true;
+		}
+
+		if (Hit.bStartPenetrating)
+		{
+			return false;
+		}
+
+		// 原来的中心在阻挡之前时保持不变，否则停在阻挡处（稍微向后退一点，避免贴着表面）
+		if (FVector::DistSquared(SweepStart, Hit.Location) < FMath::Square(HeightDelta))
+		{
+			OutLocation = Hit.Location + (SweepStart - SweepEnd).GetSafeNormal() * 0.1f;
+		}
+		return true;
+	};
+
+	// 一般是下方有地面，先向下扫描；上方有天花板或者悬垂物时起点穿透，再从保持顶部不动的位置向上扫描
+	return SweepForRestoreLocation(Start, End) || SweepForRestoreLocation(End, Start);
+}
+
+bool UCustomMovementComponent::ShouldReprobeClimbSurface() const
+{
+	if (!bHasClimbSurfaceBaseCache)
+	{
+		return true;
+	}
+
+	const UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+	if (!MovementBase)
+	{
+		// 基座被销毁
+		return true;
+	}
+
+	if (HasAnimRootMotion() || CurrentRootMotion.HasOverrideVelocity() || !Acceleration.IsNearlyZero() || !Velocity.IsNearlyZero(1.f))
+	{
+		// 角色自身在移动
+		return true;
+	}
+
+	if (GetWorld()->GetTimeSeconds() - LastClimbSurfaceProbeTime > ClimbSurfaceMaxCacheTime)
+	{
+		return true;
+	}
+
+	// 角色相对基座的位置发生了偏移（例如被推动）
+	FTransform BaseTransform;
+	GetClimbSurfaceBaseTransform(BaseTransform);
+	const FVector BaseLocalLocation = BaseTransform.InverseTransformPosition(UpdatedComponent->GetComponentLocation());
+	return FVector::DistSquared(BaseLocalLocation, LastProbeBaseLocalLocation) > FMath::Square(ClimbSurfaceReprobeDistance);
+}
+
+void UCustomMovementComponent::UpdateClimbSurfaceBase()
+{
+	// 使用离表面平均位置最近的命中组件作为基座
+	UPrimitiveComponent* NewBase = nullptr;
+	FName NewBaseBone = NAME_None;
+	float BestDistanceSquared = TNumericLimits<float>::Max();
+	for (const FHitResult& Hit : ClimbableSurfaceTraceHits)
+	{
+		UPrimitiveComponent* HitComponent = Hit.GetComponent();
+		const float DistanceSquared = FVector::DistSquared(Hit.ImpactPoint, CurrentClimbableSurfaceLocation);
+		if (HitComponent && DistanceSquared < BestDistanceSquared)
+		{
+			NewBase = HitComponent;
+			NewBaseBone = Hit.BoneName;
+			BestDistanceSquared = DistanceSquared;
+		}
+	}
+
+	if (!bTrackClimbSurfaceBones || !Cast<USkeletalMeshComponent>(NewBase))
+	{
+		// 只有骨骼网格以命中的骨骼为基座
+		NewBaseBone = NAME_None;
+	}
+
+	if (!NewBase || CurrentClimbableSurfaceNormal.IsNearlyZero())
+	{
+		InvalidateClimbSurfaceBase();
+		CharacterOwner->SetBase(nullptr);
+		return;
+	}
+
+	// 和行走时一样设置基座，基座的平移和旋转由MaybeUpdateBasedMovement施加到角色上
+	CharacterOwner->SetBase(NewBase, NewBaseBone);
+
+	FTransform BaseTransform;
+	GetClimbSurfaceBaseTransform(BaseTransform);
+	ClimbSurfaceLocalLocation = BaseTransform.InverseTransformPosition(CurrentClimbableSurfaceLocation);
+	ClimbSurfaceLocalNormal = BaseTransform.InverseTransformVectorNoScale(CurrentClimbableSurfaceNormal);
+	LastProbeBaseLocalLocation = BaseTransform.InverseTransformPosition(UpdatedComponent->GetComponentLocation());
+	LastClimbSurfaceProbeTime = GetWorld()->GetTimeSeconds();
+	bHasClimbSurfaceBaseCache = true;
+}
+
+void UCustomMovementComponent::RefreshClimbSurfaceFromBase()
+{
+	FTransform BaseTransform;
+	GetClimbSurfaceBaseTransform(BaseTransform);
+	CurrentClimbableSurfaceLocation = BaseTransform.TransformPosition(ClimbSurfaceLocalLocation);
+	CurrentClimbableSurfaceNormal = BaseTransform.TransformVectorNoScale(ClimbSurfaceLocalNormal);
+}
+
+void UCustomMovementComponent::InvalidateClimbSurfaceBase()
+{
+	bHasClimbSurfaceBaseCache = false;
+}
+
+bool UCustomMovementComponent::GetClimbSurfaceBaseTransform(FTransform& OutTransform) const
+{
+	// 和基座移动使用同样的变换，基座是骨骼网格时取基座骨骼的变换
+	FVector BaseLocation;
+	FQuat BaseQuat;
+	if (!MovementBaseUtility::GetMovementBaseTransform(CharacterOwner->GetMovementBase(), CharacterOwner->GetBasedMovement().BoneName, BaseLocation, BaseQuat))
+	{
+		OutTransform = FTransform::Identity;
+		return false;
+	}
+
+	OutTransform = FTransform(BaseQuat, BaseLocation);
+	return true;
+}
+
+bool UCustomMovementComponent::TraceClimbableBoneBodies(const FVector& Start, const FVector& End)
+{
+	const FBasedMovementInfo& BasedMovement = CharacterOwner->GetBasedMovement();
+	const USkeletalMeshComponent* SkeletalMesh = Cast<USkeletalMeshComponent>(BasedMovement.MovementBase);
+	if (!IsClimbing() || !SkeletalMesh || BasedMovement.BoneName.IsNone())
+	{
+		return false;
+	}
+
+	if (ClimbBoneMesh.Get() != SkeletalMesh || ClimbBoneName != BasedMovement.BoneName)
+	{
+		UpdateClimbBoneBodies(SkeletalMesh, BasedMovement.BoneName);
+	}
+
+	// 只对这几个物理体做窄相扫描，不经过场景的宽相
+	const FCollisionShape Capsule = FCollisionShape::MakeCapsule(ClimbCapsuleTraceRadius, ClimbCapsuleTraceHalfHeight);
+	TArray<FHitResult> BoneHits;
+	for (const int32 BodyIndex : ClimbBoneBodies)
+	{
+		const FBodyInstance* Body = SkeletalMesh->Bodies.IsValidIndex(BodyIndex) ? SkeletalMesh->Bodies[BodyIndex] : nullptr;
+		FHitResult Hit;
+		if (Body && Body->Sweep(Hit, Start, End, FQuat::Identity, Capsule))
+		{
+			Hit.Component = const_cast<USkeletalMeshComponent*>(SkeletalMesh);
+			Hit.BoneName = SkeletalMesh->GetBoneName(Body->InstanceBoneIndex);
+			Hit.Item = BodyIndex;
+			if (bUseClimbSurfaceMaterials)
+			{
+				Hit.PhysMaterial = Body->GetSimplePhysicalMaterial();
+			}
+			BoneHits.Add(Hit);
+		}
+	}
+
+	ClimbTraceContext.NumTraces += ClimbBoneBodies.Num();
+	INC_DWORD_STAT_BY(STAT_ClimbBoneBodySweeps, ClimbBoneBodies.Num());
+
+	if (BoneHits.IsEmpty())
+	{
+		// 已经离开这些物理体，由场景扫描重新找到骨骼
+		return false;
+	}
+
+	ClimbableSurfaceTraceHits = MoveTemp(BoneHits);
+	return true;
+}
+
+void UCustomMovementComponent::UpdateClimbBoneBodies(const USkeletalMeshComponent* SkeletalMesh, FName BoneName)
+{
+	ClimbBoneMesh = SkeletalMesh;
+	ClimbBoneName = BoneName;
+	ClimbBoneBodies.Reset();
+
+	// 骨骼自身没有物理体时沿父骨骼向上找到有物理体的骨骼
+	auto FindBodyBone = [SkeletalMesh](FName Bone)
+	{
+		while (!Bone.IsNone() && !SkeletalMesh->GetBodyInstance(Bone))
+		{
+			Bone = SkeletalMesh->GetParentBone(Bone);
+		}
+		return Bone;
+	};
+
+	const FName BodyBone = FindBodyBone(BoneName);
+	const FName ParentBodyBone = FindBodyBone(SkeletalMesh->GetParentBone(BodyBone));
+
+	// 当前物理体、父物理体和直接子物理体（只在骨骼改变时遍历一次）
+	for (int32 BodyIndex = 0; BodyIndex < SkeletalMesh->Bodies.Num(); BodyIndex++)
+	{
+		const FBodyInstance* Body = SkeletalMesh->Bodies[BodyIndex];
+		if (!Body || !Body->IsValidBodyInstance())
+		{
+			continue;
+		}
+
+		const FName Bone = SkeletalMesh->GetBoneName(Body->InstanceBoneIndex);
+		if (Bone == BodyBone || Bone == ParentBodyBone || FindBodyBone(SkeletalMesh->GetParentBone(Bone)) == BodyBone)
+		{
+			ClimbBoneBodies.Add(BodyIndex);
+		}
+	}
+}
+
+FVector UCustomMovementComponent::GetUnRotatedClimbVelocity() const
+{
+	// 获取未旋转的攀爬速度（因为四元数旋转的特性，所以要对速度进行反旋转，就能得到未旋转的速度）
+	return UKismetMathLibrary::Quat_UnrotateVector(UpdatedComponent->GetComponentQuat(), Velocity);
+}
+
+void UCustomMovementComponent::ClimbDash()
+{
+	if (BufferClimbAction(EClimbBufferedAction::Dash))
+	{
+		// 蒙太奇播放中，缓存到可以执行为止
+		return;
+	}
+
+	// 攀爬冲刺
+	if (!IsClimbing() || !ClimbTraversal.CanTransitionTo(EClimbTraversalState::Dashing))
+	{
+		return;
+	}
+
+	if (!CurrentClimbSurface.bAllowDash)
+	{
+		// 当前表面的材质不允许冲刺
+		RecordClimbTelemetry(EClimbTelemetryEvent::DashRejected);
+		return;
+	}
+
+	const FVector LastInputVector = GetLastInputVector().GetSafeNormal();
+
+	// 输入投影到攀爬平面（角色右向量和上向量）
+	const FVector2D UnRotatedInput(
+		FVector::DotProduct(LastInputVector, UpdatedComponent->GetRightVector()),
+		FVector::DotProduct(LastInputVector, UpdatedComponent->GetUpVector()));
+
+	if (UnRotatedInput.IsNearlyZero())
+	{
+		return;
+	}
+
+	TArray<FClimbDashCandidate> Candidates;
+	QueryClimbDashCandidates(Candidates);
+
+	// 选中的方向还要校验整条运动扭曲后的根动作轨迹，被挡住时换下一个方向
+	int32 DirectionIndex = SelectClimbDashDirection(UnRotatedInput.GetSafeNormal(), Candidates);
+	while (DirectionIndex != INDEX_NONE && !ValidateClimbDashTrajectory(ClimbDashDirections[DirectionIndex], Candidates[DirectionIndex].TargetPoint))
+	{
+		Candidates[DirectionIndex].bValid = false;
+		DirectionIndex = SelectClimbDashDirection(UnRotatedInput.GetSafeNormal(), Candidates);
+	}
+
+	if (DirectionIndex == INDEX_NONE)
+	{
+		RecordClimbTelemetry(EClimbTelemetryEvent::DashRejected);
+		return;
+	}
+
+	const FClimbDashDirection& DashDirection = ClimbDashDirections[DirectionIndex];
+	SetMotionWarpingTarget(DashDirection.WarpTargetName, Candidates[DirectionIndex].TargetPoint);
+	PlayClimbMontage(DashDirection.Montage);
+
+	FClimbMoveClaim Claim;
+	Claim.MoveType = EClimbMoveType::Dash;
+	Claim.SurfaceComponent = Candidates[DirectionIndex].TargetComponent;
+	Claim.SurfacePoint = Candidates[DirectionIndex].TargetPoint;
+	Claim.SurfaceNormal = Candidates[DirectionIndex].TargetNormal;
+	Claim.DashDirectionIndex = static_cast<int8>(DirectionIndex);
+	SendClimbMoveClaim(Claim);
+	RecordClimbTelemetry(EClimbTelemetryEvent::Dash);
+}
+
+bool UCustomMovementComponent::WallJump()
+{
+	if (BufferClimbAction(EClimbBufferedAction::WallJump))
+	{
+		// 蒙太奇播放中，缓存到可以执行为止
+		return false;
+	}
+
+	if (!IsClimbing() || HasAnimRootMotion() || IsInCornerTransition())
+	{
+		return false;
+	}
+
+	const FVector LaunchLocation = UpdatedComponent->GetComponentLocation();
+	const FVector ComponentRight = UpdatedComponent->GetRightVector();
+	const FVector LastInputVector = GetLastInputVector().GetSafeNormal();
+	const float LateralInput = FVector::DotProduct(LastInputVector, ComponentRight);
+
+	// 水平方向：离开墙面，横向输入让方向偏向一侧
+	const FVector WallNormal2D = CurrentClimbableSurfaceNormal.GetSafeNormal2D();
+	const FVector HorizontalDirection = (WallNormal2D * (1.f - FMath::Abs(LateralInput) * 0.5f) + ComponentRight * LateralInput).GetSafeNormal2D();
+	if (HorizontalDirection.IsNearlyZero() || WallJumpPitchAngles.IsEmpty())
+	{
+		return false;
+	}
+
+	// 所有候选仰角的抛物线共用一次宽相查询
+	const float GravityZ = GetGravityZ();
+	const int32 NumSegments = FMath::Max(WallJumpTrajectorySegments, 1);
+	FBox QueryBounds(ForceInit);
+	for (const float PitchDegrees : WallJumpPitchAngles)
+	{
+		const FVector LaunchVelocity = GetWallJumpVelocity(HorizontalDirection, PitchDegrees);
+		for (int32 Segment = 0; Segment <= NumSegments; Segment++)
+		{
+			const float Time = WallJumpMaxFlightTime * Segment / NumSegments;
+			QueryBounds += LaunchLocation + LaunchVelocity * Time + FVector(0.f, 0.f, 0.5f * GravityZ * Time * Time);
+		}
+	}
+	QueryBounds = QueryBounds.ExpandBy(CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius());
+
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbWallJump), false, CharacterOwner);
+	TArray<UPrimitiveComponent*> CandidateComponents;
+	GatherClimbQueryComponents(QueryBounds, QueryParams, CandidateComponents);
+
+	FVector LaunchVelocity = GetWallJumpVelocity(HorizontalDirection, WallJumpPitchAngles[WallJumpPitchAngles.Num() / 2]);
+	FClimbJumpTarget SolvedTarget;
+	for (const float PitchDegrees : WallJumpPitchAngles)
+	{
+		const FVector CandidateVelocity = GetWallJumpVelocity(HorizontalDirection, PitchDegrees);
+		if (SolveWallJumpTrajectory(LaunchLocation, CandidateVelocity, CandidateComponents, SolvedTarget))
+		{
+			LaunchVelocity = CandidateVelocity;
+			break;
+		}
+	}
+
+	// 没有找到落点时也会起跳（普通的蹬墙跳），只是空中不会自动抓墙
+	StopClimbing();
+	CharacterOwner->LaunchCharacter(LaunchVelocity, true, true);
+
+	WallJumpTarget = SolvedTarget;
+	WallJumpStartTime = GetWorld()->GetTimeSeconds();
+	return true;
+}
+
+FVector UCustomMovementComponent::GetWallJumpVelocity(const FVector& HorizontalDirection, float PitchDegrees) const
+{
+	const float PitchRadians = FMath::DegreesToRadians(PitchDegrees);
+	return (HorizontalDirection * FMath::Cos(PitchRadians) + FVector::UpVector * FMath::Sin(PitchRadians)) * WallJumpSpeed;
+}
+
+bool UCustomMovementComponent::SolveWallJumpTrajectory(const FVector& LaunchLocation, const FVector& LaunchVelocity, const TArray<UPrimitiveComponent*>& CandidateComponents, FClimbJumpTarget& OutTarget) const
+{
+	CLIMB_VLOG_PROBE_SCOPE("WallJumpTrajectory");
+
+	OutTarget = FClimbJumpTarget();
+
+	const float GravityZ = GetGravityZ();
+	const FCollisionShape SweepShape = FCollisionShape::MakeSphere(CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius());
+	const FVector LaunchDirection = LaunchVelocity.GetSafeNormal2D();
+
+	auto GetTrajectoryLocation = [&LaunchLocation, &LaunchVelocity, GravityZ](float Time)
+	{
+		return LaunchLocation + LaunchVelocity * Time + FVector(0.f, 0.f, 0.5f * GravityZ * Time * Time);
+	};
+
+	// 分段数是除数，至少为1
+	const int32 NumSegments = FMath::Max(WallJumpTrajectorySegments, 1);
+	for (int32 Segment = 0; Segment < NumSegments; Segment++)
+	{
+		const float StartTime = WallJumpMaxFlightTime * Segment / NumSegments;
+		const float EndTime = WallJumpMaxFlightTime * (Segment + 1) / NumSegments;
+		const FVector SegmentStart = GetTrajectoryLocation(StartTime);
+		const FVector SegmentEnd = GetTrajectoryLocation(EndTime);
+
+		// 找到这一段上最早的命中
+		FHitResult FirstHit;
+		bool bHit = false;
+		for (UPrimitiveComponent* Component : CandidateComponents)
+		{
+			FHitResult Hit;
+			if (Component->SweepComponent(Hit, SegmentStart, SegmentEnd, FQuat::Identity, SweepShape) && !Hit.bStartPenetrating && (!bHit || Hit.Time < FirstHit.Time))
+			{
+				FirstHit = Hit;
+				bHit = true;
+			}
+		}
+
+		CLIMB_VLOG_LINE_TRACE(CharacterOwner, SegmentStart, SegmentEnd, bHit ? FirstHit : FHitResult());
+
+		if (!bHit)
+		{
+			continue;
+		}
+
+		// 第一个命中就是落点：必须是可攀爬的墙面，并且朝向来的方向
+		if (!IsClimbableSurfaceNormal(FirstHit.ImpactNormal) || FVector::DotProduct(FirstHit.ImpactNormal, LaunchDirection) > -0.5f)
+		{
+			return false;
+		}
+
+		OutTarget.bValid = true;
+		OutTarget.GrabLocation = FirstHit.Location;
+		OutTarget.SurfacePoint = FirstHit.ImpactPoint;
+		OutTarget.SurfaceNormal = FirstHit.ImpactNormal;
+		OutTarget.ArrivalTime = FMath::Lerp(StartTime, EndTime, FirstHit.Time);
+		return true;
+	}
+
+	return false;
+}
+
+void UCustomMovementComponent::TickWallJumpRegrab()
+{
+	if (!IsFalling())
+	{
+		// 已经落地或者进入其他模式
+		WallJumpTarget = FClimbJumpTarget();
+		return;
+	}
+
+	const float ElapsedTime = GetWorld()->GetTimeSeconds() - WallJumpStartTime;
+	if (ElapsedTime < WallJumpTarget.ArrivalTime - WallJumpRegrabLeadTime)
+	{
+		return;
+	}
+
+	const FClimbJumpTarget Target = WallJumpTarget;
+	WallJumpTarget = FClimbJumpTarget();
+
+	if (FVector::DistSquared(UpdatedComponent->GetComponentLocation(), Target.GrabLocation) > FMath::Square(WallJumpRegrabTolerance))
+	{
+		// 轨迹被干扰（撞到东西、空中控制），放弃自动抓墙
+		return;
+	}
+
+	// 直接使用求解的落点，不需要再检测墙面
+	FHitResult Hit;
+	SafeMoveUpdatedComponent(Target.GrabLocation - UpdatedComponent->GetComponentLocation(), FRotationMatrix::MakeFromX(-Target.SurfaceNormal).ToQuat(), true, Hit);
+
+	CurrentClimbableSurfaceLocation = Target.SurfacePoint;
+	CurrentClimbableSurfaceNormal = Target.SurfaceNormal;
+	LastValidClimbableSurfaceLocation = Target.SurfacePoint;
+	LastValidClimbableSurfaceNormal = Target.SurfaceNormal;
+
+	StopMovementImmediately();
+	StartClimbing();
+}
+
+void UCustomMovementComponent::BuildClimbDashDirections()
+{
+	ClimbDashDirections.Reset();
+
+	if (ClimbDashDirectionTable)
+	{
+		for (const TPair<FName, uint8*>& Row : ClimbDashDirectionTable->GetRowMap())
+		{
+			const FClimbDashDirection* DashDirection = reinterpret_cast<const FClimbDashDirection*>(Row.Value);
+			if (DashDirection && DashDirection->Montage && !DashDirection->Direction.IsNearlyZero())
+			{
+				FClimbDashDirection& NewDirection = ClimbDashDirections.Add_GetRef(*DashDirection);
+				NewDirection.Direction = NewDirection.Direction.GetSafeNormal();
+			}
+		}
+		return;
+	}
+
+	// 没有数据表：8方向，斜向使用主轴（水平优先）的蒙太奇，向上的方向需要安全检测
+	for (int32 Index = 0; Index < 8; Index++)
+	{
+		const float Angle = Index * UE_HALF_PI * 0.5f;
+		const FVector2D Direction(FMath::Sin(Angle), FMath::Cos(Angle));
+
+		FClimbDashDirection NewDirection;
+		NewDirection.Direction = Direction;
+
+		if (FMath::Abs(Direction.X) >= 0.5f)
+		{
+			NewDirection.Montage = Direction.X > 0.f ? AnimMontage_ClimbDashRight : AnimMontage_ClimbDashLeft;
+			NewDirection.WarpTargetName = Direction.X > 0.f ? FName("DashRightTargetPoint") : FName("DashLeftTargetPoint");
+			NewDirection.ProbeDistance = 200.f;
+			NewDirection.SafetyProbeDistance = Direction.Y > 0.5f ? 350.f : 0.f;
+		}
+		else if (Direction.Y > 0.f)
+		{
+			NewDirection.Montage = AnimMontage_ClimbDashUp;
+			NewDirection.WarpTargetName = FName("DashUpTargetPoint");
+			NewDirection.ProbeDistance = -30.f;
+			NewDirection.SafetyProbeDistance = 150.f;
+		}
+		else
+		{
+			NewDirection.Montage = AnimMontage_ClimbDashDown;
+			NewDirection.WarpTargetName = FName("DashDownTargetPoint");
+			NewDirection.ProbeDistance = 300.f;
+		}
+
+		if (NewDirection.Montage)
+		{
+			ClimbDashDirections.Add(NewDirection);
+		}
+	}
+}
+
+void UCustomMovementComponent::QueryClimbDashCandidates(TArray<FClimbDashCandidate>& OutCandidates) const
+{
+	CLIMB_VLOG_PROBE_SCOPE("DashCandidates");
+
+	OutCandidates.SetNum(ClimbDashDirections.Num());
+
+	if (ClimbDashDirections.IsEmpty())
+	{
+		return;
+	}
+
+	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
+	const FVector ComponentRight = UpdatedComponent->GetRightVector();
+	const FVector ComponentUp = UpdatedComponent->GetUpVector();
+	const FVector EyeLocation = UpdatedComponent->GetComponentLocation() + ComponentUp * CharacterOwner->BaseEyeHeight;
+
+	// 每个方向的目标检测线段和安全检测线段
+	TArray<TPair<FVector, FVector>, TInlineAllocator<32>> TraceSegments;
+	FBox QueryBounds(ForceInit);
+	for (const FClimbDashDirection& DashDirection : ClimbDashDirections)
+	{
+		const FVector WorldDirection = (ComponentRight * DashDirection.Direction.X + ComponentUp * DashDirection.Direction.Y).GetSafeNormal();
+
+		const FVector TargetStart = EyeLocation + WorldDirection * DashDirection.ProbeDistance;
+		const FVector SafetyStart = EyeLocation + WorldDirection * DashDirection.SafetyProbeDistance;
+
+		TraceSegments.Emplace(TargetStart, TargetStart + ComponentForward * DashDirection.ForwardTraceDistance);
+		TraceSegments.Emplace(SafetyStart, SafetyStart + ComponentForward * DashDirection.ForwardTraceDistance);
+	}
+
+	for (const TPair<FVector, FVector>& Segment : TraceSegments)
+	{
+		QueryBounds += Segment.Key;
+		QueryBounds += Segment.Value;
+	}
+
+	// 一次宽相查询得到所有方向可能命中的组件
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbDashCandidates), false, CharacterOwner);
+	TArray<UPrimitiveComponent*> CandidateComponents;
+	GatherClimbQueryComponents(QueryBounds, QueryParams, CandidateComponents);
+
+	if (CandidateComponents.IsEmpty())
+	{
+		return;
+	}
+
+	// 逐方向只对收集到的组件做窄相线性检测，取最近的命中
+	auto TraceSegment = [&](const TPair<FVector, FVector>& Segment, FHitResult& OutHit)
+	{
+		bool bHit = false;
+		for (UPrimitiveComponent* Component : CandidateComponents)
+		{
+			FHitResult ComponentHit;
+			if (Component->LineTraceComponent(ComponentHit, Segment.Key, Segment.Value, QueryParams) && (!bHit || ComponentHit.Time < OutHit.Time))
+			{
+				OutHit = ComponentHit;
+				bHit = true;
+			}
+		}
+		CLIMB_VLOG_LINE_TRACE(CharacterOwner, Segment.Key, Segment.Value, bHit ? OutHit : FHitResult());
+		return bHit;
+	};
+
+	for (int32 Index = 0; Index < ClimbDashDirections.Num(); Index++)
+	{
+		FHitResult TargetHit;
+		if (!TraceSegment(TraceSegments[Index * 2], TargetHit))
+		{
+			continue;
+		}
+
+		if (ClimbDashDirections[Index].SafetyProbeDistance > 0.f)
+		{
+			FHitResult SafetyHit;
+			if (!TraceSegment(TraceSegments[Index * 2 + 1], SafetyHit))
+			{
+				continue;
+			}
+		}
+
+		OutCandidates[Index].bValid = true;
+		OutCandidates[Index].TargetPoint = TargetHit.ImpactPoint;
+		OutCandidates[Index].TargetNormal = TargetHit.ImpactNormal;
+		OutCandidates[Index].TargetComponent = TargetHit.GetComponent();
+	}
+}
+
+int32 UCustomMovementComponent::SelectClimbDashDirection(const FVector2D& UnRotatedInput, const TArray<FClimbDashCandidate>& Candidates) const
+{
+	// 在输入方向附近的可达方向中选择最接近输入的一个
+	int32 BestIndex = INDEX_NONE;
+	float BestAlignment = ClimbDashMinInputAlignment;
+	for (int32 Index = 0; Index < ClimbDashDirections.Num(); Index++)
+	{
+		const float Alignment = FVector2D::DotProduct(UnRotatedInput, ClimbDashDirections[Index].Direction);
+		if (Candidates.IsValidIndex(Index) && Candidates[Index].bValid && Alignment >= BestAlignment)
+		{
+			BestIndex = Index;
+			BestAlignment = Alignment;
+		}
+	}
+	return BestIndex;
+}
+
+void UCustomMovementComponent::GatherClimbQueryComponents(const FBox& QueryBounds, const FCollisionQueryParams& QueryParams, TArray<UPrimitiveComponent*>& OutComponents) const
+{
+	LLM_SCOPE_BYTAG(Climbing_Probes);
+
+	OutComponents.Reset();
+
+	TArray<FOverlapResult> Overlaps;
+	ClimbTraceContext.OverlapMulti(Overlaps, QueryBounds.GetCenter(), FCollisionShape::MakeBox(QueryBounds.GetExtent() + FVector(1.f)), QueryParams);
+
+	CLIMB_VLOG_QUERY_BOUNDS(CharacterOwner, QueryBounds, Overlaps.Num());
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		if (UPrimitiveComponent* Component = Overlap.GetComponent())
+		{
+			OutComponents.AddUnique(Component);
+		}
+	}
+
+	CS_ClimbMemory::NoteArray(Overlaps);
+	CS_ClimbMemory::NoteArray(OutComponents);
+}
+
+void UCustomMovementComponent::BakeClimbDashTrajectories()
+{
+	ClimbDashTrajectories.Reset();
+
+	const FQuat MeshRotationOffset = CharacterOwner->GetBaseRotationOffset();
+	const int32 NumSamples = FMath::Max(ClimbDashTrajectorySamples, 2);
+
+	for (const FClimbDashDirection& DashDirection : ClimbDashDirections)
+	{
+		if (!DashDirection.Montage || ClimbDashTrajectories.Contains(DashDirection.Montage))
+		{
+			continue;
+		}
+
+		// 根动作在网格空间，转换到角色本地空间后按时间均匀采样
+		FClimbDashTrajectory& Trajectory = ClimbDashTrajectories.Add(DashDirection.Montage);
+		Trajectory.Points.Reserve(NumSamples + 1);
+
+		const float PlayLength = DashDirection.Montage->GetPlayLength();
+		for (int32 SampleIndex = 0; SampleIndex <= NumSamples; SampleIndex++)
+		{
+			const float SampleTime = PlayLength * SampleIndex / NumSamples;
+			const FTransform RootMotion = DashDirection.Montage->ExtractRootMotionFromTrackRange(0.f, SampleTime);
+			Trajectory.Points.Add(MeshRotationOffset.RotateVector(RootMotion.GetTranslation()));
+		}
+	}
+}
+
+bool UCustomMovementComponent::ValidateClimbDashTrajectory(const FClimbDashDirection& DashDirection, const FVector& TargetPoint) const
+{
+	CLIMB_VLOG_PROBE_SCOPE("DashTrajectory");
+
+	const FClimbDashTrajectory* Trajectory = ClimbDashTrajectories.Find(DashDirection.Montage);
+	if (!Trajectory || Trajectory->Points.Num() < 2)
+	{
+		// 没有根动作轨迹，只能信任目标点检测
+		return true;
+	}
+
+	const FVector StartLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat StartRotation = UpdatedComponent->GetComponentQuat();
+
+	// 运动扭曲让根骨骼在结束时对齐目标点，胶囊体中心相对根骨骼的偏移是网格偏移的反方向
+	const FVector RawEnd = StartLocation + StartRotation.RotateVector(Trajectory->Points.Last());
+	const FVector WarpedEnd = TargetPoint - StartRotation.RotateVector(CharacterOwner->GetBaseTranslationOffset());
+	const FVector WarpCorrection = WarpedEnd - RawEnd;
+
+	TArray<FVector, TInlineAllocator<16>> WarpedPoints;
+	FBox QueryBounds(ForceInit);
+	for (int32 Index = 0; Index < Trajectory->Points.Num(); Index++)
+	{
+		// 近似扭曲：修正量沿轨迹线性分配
+		const float Alpha = static_cast<float>(Index) / (Trajectory->Points.Num() - 1);
+		const FVector WarpedPoint = StartLocation + StartRotation.RotateVector(Trajectory->Points[Index]) + WarpCorrection * Alpha;
+		WarpedPoints.Add(WarpedPoint);
+		QueryBounds += WarpedPoint;
+	}
+
+	const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
+	const float CapsuleRadius = FMath::Max(Capsule->GetScaledCapsuleRadius() - ClimbDashSweepShrink, 1.f);
+	const float CapsuleHalfHeight = FMath::Max(Capsule->GetScaledCapsuleHalfHeight() - ClimbDashSweepShrink, CapsuleRadius);
+	const FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight);
+	QueryBounds = QueryBounds.ExpandBy(CapsuleHalfHeight);
+
+	// 一次宽相查询覆盖整条轨迹，之后逐段只对这些组件做胶囊体扫描
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbDashTrajectory), false, CharacterOwner);
+	TArray<UPrimitiveComponent*> CandidateComponents;
+	GatherClimbQueryComponents(QueryBounds, QueryParams, CandidateComponents);
+
+	const FVector WallFacing = -UpdatedComponent->GetForwardVector();
+	for (int32 Index = 0; Index + 1 < WarpedPoints.Num(); Index++)
+	{
+		CLIMB_VLOG_SEGMENT(CharacterOwner, "DashTrajectory", WarpedPoints[Index], WarpedPoints[Index + 1], FColor::Orange);
+
+		for (UPrimitiveComponent* Component : CandidateComponents)
+		{
+			FHitResult Hit;
+			if (!Component->SweepComponent(Hit, WarpedPoints[Index], WarpedPoints[Index + 1], StartRotation, CapsuleShape))
+			{
+				continue;
+			}
+
+			if (FVector::DotProduct(Hit.ImpactNormal, WallFacing) > 0.7f)
+			{
+				// 正在攀爬的墙面本身，不算障碍
+				continue;
+			}
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool UCustomMovementComponent::IsClimbDashMontage(const UAnimMontage* Montage) const
+{
+	return Montage && ClimbDashDirections.ContainsByPredicate([Montage](const FClimbDashDirection& DashDirection)
+	{
+		return DashDirection.Montage == Montage;
+	});
+}
+
+void UCustomMovementComponent::OnClimbMontageBlendingOut(UAnimMontage* Montage, bool bBInterrupted)
+{
+	if (bRestoringClimbSnapshot)
+	{
+		// 恢复快照时切换蒙太奇，不触发移动模式切换
+		return;
+	}
+
+	if (Montage == ClimbTransitionAppliedMontage)
+	{
+		// 已经在切换窗口中切换过移动模式
+		ClimbTransitionAppliedMontage = nullptr;
+	}
+	else if (!bBInterrupted || Montage == AnimMontage_ClimbToTop || Montage == AnimMontage_Vaulting)
+	{
+		// 如果是上墙蒙太奇被打断，不继续攀爬；上到顶端被打断时仍然回到地面
+		ApplyClimbMontageTransition(Montage);
+		ClimbTransitionAppliedMontage = nullptr;
+	}
+
+	ConsumeBufferedClimbAction();
+}
+
+void UCustomMovementComponent::ApplyClimbMontageTransition(const UAnimMontage* Montage)
+{
+	if (!Montage || Montage == ClimbTransitionAppliedMontage)
+	{
+		return;
+	}
+
+	if (Montage == AnimMontage_StandToWallUp 
+		|| Montage == AnimMontage_ClimbToDown 
+		|| IsClimbDashMontage(Montage))
+	{
+		ClimbTransitionAppliedMontage = Montage;
+		StartClimbing();
+	}
+	else if (Montage == AnimMontage_ClimbToTop || Montage == AnimMontage_Vaulting)
+	{
+		// 如果是上到顶端蒙太奇
+		ClimbTransitionAppliedMontage = Montage;
+		SetMovementMode(MOVE_Walking);
+	}
+}
+
+void UCustomMovementComponent::NotifyClimbWindowBegin(EClimbWindowType WindowType, const UAnimMontage* Montage)
+{
+	OpenClimbWindows |= 1 << static_cast<uint8>(WindowType);
+
+	switch (WindowType)
+	{
+	case EClimbWindowType::MovementModeSwitch:
+		// 在标记的帧切换移动模式，淡出时不再重复切换
+		ApplyClimbMontageTransition(Montage);
+		break;
+	case EClimbWindowType::Cancel:
+		// 可以打断时立即执行缓存的输入
+		ConsumeBufferedClimbAction();
+		break;
+	default:
+		break;
+	}
+}
+
+void UCustomMovementComponent::NotifyClimbWindowEnd(EClimbWindowType WindowType)
+{
+	OpenClimbWindows &= ~(1 << static_cast<uint8>(WindowType));
+}
+
+bool UCustomMovementComponent::IsClimbWindowOpen(EClimbWindowType WindowType) const
+{
+	return (OpenClimbWindows & (1 << static_cast<uint8>(WindowType))) != 0;
+}
+
+bool UCustomMovementComponent::IsAcceptingBufferedClimbInput() const
+{
+	return IsClimbWindowOpen(EClimbWindowType::InputAccept) || IsClimbWindowOpen(EClimbWindowType::Cancel);
+}
+
+bool UCustomMovementComponent::IsClimbMontageLocked() const
+{
+	// 淡出中的蒙太奇不算，新的动作可以直接接上
+	return CharacterAnimInstance
+		&& CharacterAnimInstance->GetCurrentActiveMontage()
+		&& !IsClimbWindowOpen(EClimbWindowType::Cancel);
+}
+
+bool UCustomMovementComponent::BufferClimbAction(EClimbBufferedAction Action)
+{
+	if (!IsClimbMontageLocked())
+	{
+		return false;
+	}
+
+	if (IsClimbWindowOpen(EClimbWindowType::InputAccept))
+	{
+		// 窗口内的输入被缓存，窗口外的输入和以前一样被丢弃
+		BufferedClimbAction = Action;
+		BufferedClimbActionTime = GetWorld()->GetTimeSeconds();
+	}
+	return true;
+}
+
+void UCustomMovementComponent::ConsumeBufferedClimbAction()
+{
+	const EClimbBufferedAction Action = BufferedClimbAction;
+	BufferedClimbAction = EClimbBufferedAction::None;
+
+	if (Action == EClimbBufferedAction::None || GetWorld()->GetTimeSeconds() - BufferedClimbActionTime > ClimbInputBufferTime)
+	{
+		return;
+	}
+
+	switch (Action)
+	{
+	case EClimbBufferedAction::Dash:
+		ClimbDash();
+		break;
+	case EClimbBufferedAction::WallJump:
+		WallJump();
+		break;
+	default:
+		break;
+	}
+}
+
+void UCustomMovementComponent::PlayClimbMontage(UAnimMontage* MontageToPlay)
+{
+	if (CharacterAnimInstance && MontageToPlay)
+	{
+		if (CharacterAnimInstance->Montage_IsPlaying(MontageToPlay))
+		{
+			// 如果动画正在播放，不重复播放
+			return;
+		}
+		if (IsClimbMontageLocked())
+		{
+			// 如果有动画正在播放并且不在打断窗口内，不播放
+			return;
+		}
+
+		const EClimbTraversalState MontageState = GetTraversalStateForMontage(MontageToPlay);
+		if (MontageState != EClimbTraversalState::MAX && !ClimbTraversal.CanTransitionTo(MontageState))
+		{
+			// 当前状态不允许切换到这个蒙太奇对应的状态
+			return;
+		}
+		
+		// 打断窗口内直接播放，新蒙太奇会打断当前蒙太奇
+		if (CharacterAnimInstance->Montage_Play(MontageToPlay) > 0.f && MontageState != EClimbTraversalState::MAX)
+		{
+			ClimbTraversal.TransitionTo(MontageState);
+		}
+	}
+}
+
+void UCustomMovementComponent::TryStartVaulting()
+{
+	FVector VaultStartLocation = FVector::ZeroVector;
+	FVector VaultLandLocation = FVector::ZeroVector;
+	FHitResult VaultStartHit;
+	FHitResult VaultLandHit;
+	if (ClimbTraversal.CanTransitionTo(EClimbTraversalState::Vaulting) && CanStartVaulting(VaultStartLocation, VaultLandLocation, &VaultStartHit, &VaultLandHit))
+	{
+		// 如果可以开始翻越
+		// Start vaulting
+		SetMotionWarpingTarget("VaultStartPoint", VaultStartLocation);
+		SetMotionWarpingTarget("VaultEndPoint", VaultLandLocation);
+
+		StartClimbing();
+		PlayClimbMontage(AnimMontage_Vaulting);
+
+		FClimbMoveClaim Claim;
+		Claim.MoveType = EClimbMoveType::Vault;
+		Claim.SurfaceComponent = VaultStartHit.GetComponent();
+		Claim.SurfacePoint = VaultStartLocation;
+		Claim.SurfaceNormal = VaultStartHit.ImpactNormal;
+		Claim.TargetComponent = VaultLandHit.GetComponent();
+		Claim.TargetPoint = VaultLandLocation;
+		Claim.TargetNormal = VaultLandHit.ImpactNormal;
+		SendClimbMoveClaim(Claim);
+		RecordClimbTelemetry(EClimbTelemetryEvent::Vault);
+	}
+}
+
+bool UCustomMovementComponent::CanStartVaulting(FVector& OutVaultStartLocation, FVector& OutVaultLandLocation, FHitResult* OutVaultStartHit, FHitResult* OutVaultLandHit) const
+{
+	CLIMB_VLOG_PROBE_SCOPE("Vault");
+
+	if (IsClimbing())
+	{
+		// 如果正在攀爬，不允许翻越
+		return false;
+	}
+	if (IsFalling())
+	{
+		// 如果正在下落，不允许翻越
+		return false;
+	}
+
+	if (TraceFromEyeHeight(100.f).bBlockingHit)
+	{
+		// 如果当前视线高度100.f位置有阻挡，不允许翻越
+		return false;
+	}
+
+	OutVaultStartLocation = FVector::ZeroVector;
+	OutVaultLandLocation = FVector::ZeroVector;
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
+	const FVector UpVector = UpdatedComponent->GetUpVector();
+	const FVector DownVector = -UpVector;
+
+	for (int32 i = 0; i < 5; i++)
+	{
+		const FVector Start = ComponentLocation + ComponentForward * 100.f * (i+1) + UpVector * 100.f;
+		const FVector End = Start + DownVector * 100.f * (i+1);
+
+		FHitResult HitResult = DoLineTraceSingleByObject(Start, End);
+
+		if (i == 0 && HitResult.bBlockingHit)
+		{
+			// 如果第一次检测到阻挡，说明角色前方0位置可以作为翻越起点
+			OutVaultStartLocation = HitResult.ImpactPoint;
+			if (OutVaultStartHit)
+			{
+				*OutVaultStartHit = HitResult;
+			}
+		}
+
+		if (i == 3 && HitResult.bBlockingHit)
+		{
+			// 如果第五次检测到阻挡，说明角色前方100位置可以作为翻越终点
+			OutVaultLandLocation = HitResult.ImpactPoint;
+			if (OutVaultLandHit)
+			{
+				*OutVaultLandHit = HitResult;
+			}
+		}
+	}
+
+	if (OutVaultStartLocation != FVector::ZeroVector && OutVaultLandLocation != FVector::ZeroVector)
+	{
+		// 如果检测到翻越起点和终点，返回true
+		return true;
+	}
+
+	return false;
+
+}
+
+void UCustomMovementComponent::SetMotionWarpingTarget(const FName& TargetSectionName, const FVector& TargetLocation) const
+{
+	if (ClimbingSystemCharacter)
+	{
+		CLIMB_VLOG_LOCATION(CharacterOwner, "WarpTarget", TargetLocation, FColor::Magenta);
+		ClimbingSystemCharacter->GetMotionWarpingComponent()->AddOrUpdateWarpTargetFromLocation(TargetSectionName, TargetLocation);
+
+		if (ClimbWarpTargetNames.Num() < FClimbSnapshot::MaxWarpTargets || ClimbWarpTargetNames.Contains(TargetSectionName))
+		{
+			ClimbWarpTargetNames.AddUnique(TargetSectionName);
+		}
+	}
+}
+
+void UCustomMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+
+	if (IsClimbing())
+	{
+		// 如果进入攀爬模式
+		InvalidateClimbSurfaceBase();		// 进入时总是重新检测一次表面
+		ClimbGripTime = 0.f;				// 重新开始计算抓握时间
+		bOrientRotationToMovement = false;	// 不根据移动方向旋转角色
+		ShrinkClimbCapsule();				// 设置胶囊体高度
+
+		OnEnterClimbState_Delegate.ExecuteIfBound();	// 触发进入攀爬状态委托
+	}
+	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == ECustomMovementMode::MOVE_Climb)
+	{
+		// 如果离开攀爬模式
+		CornerTransition = FClimbCornerTransition();	// 清除未完成的墙角过渡
+		ClimbDistanceField.Reset();						// 离开攀爬后释放距离场
+		TopOutPrediction = FClimbTopOutPrediction();	// 清除顶端预测
+		bHasFailedCornerProbe = false;
+
+		bOrientRotationToMovement = true;	// 根据移动方向旋转角色
+		TryRestoreClimbCapsule();			// 恢复胶囊体高度并重置角色旋转
+
+		StopMovementImmediately();		// 停止移动
+
+		OnExitClimbState_Delegate.ExecuteIfBound();	// 触发退出攀爬状态委托
+	}
+
+	const bool bWasLedgeHanging = PreviousMovementMode == MOVE_Custom && PreviousCustomMode == ECustomMovementMode::MOVE_LedgeHang;
+	if (IsLedgeHanging() && !bWasLedgeHanging)
+	{
+		// 如果进入挂边模式，复用攀爬输入
+		bOrientRotationToMovement = false;
+		OnEnterClimbState_Delegate.ExecuteIfBound();
+	}
+	if (bWasLedgeHanging && !IsLedgeHanging())
+	{
+		// 如果离开挂边模式
+		FailedLedgeChainDirection = 0.f;
+		bOrientRotationToMovement = true;
+		OnExitClimbState_Delegate.ExecuteIfBound();
+	}
+
+	const bool bWasOnClimbPath = PreviousMovementMode == MOVE_Custom
+		&& (PreviousCustomMode == ECustomMovementMode::MOVE_Ladder
+			|| PreviousCustomMode == ECustomMovementMode::MOVE_Rope
+			|| PreviousCustomMode == ECustomMovementMode::MOVE_Pipe
+			|| PreviousCustomMode == ECustomMovementMode::MOVE_Zipline);
+
+	if (IsOnClimbPath() && !bWasOnClimbPath)
+	{
+		// 如果进入攀爬路径模式，胶囊体保持不变
+		bOrientRotationToMovement = false;
+
+		OnEnterClimbState_Delegate.ExecuteIfBound();	// 复用进入攀爬状态委托
+	}
+	if (bWasOnClimbPath && !IsOnClimbPath())
+	{
+		// 如果离开攀爬路径模式
+		ActiveClimbPath = nullptr;
+		ClimbPathSpeed = 0.f;
+		bOrientRotationToMovement = true;
+
+		const FRotator DirtyRotation = UpdatedComponent->GetComponentRotation();
+		const FRotator CleanRotation = FRotator(0.f, DirtyRotation.Yaw, 0.f);
+		UpdatedComponent->SetRelativeRotation(CleanRotation);
+
+		OnExitClimbState_Delegate.ExecuteIfBound();	// 复用退出攀爬状态委托
+	}
+
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+}
+
+void UCustomMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
+{
+	LLM_SCOPE_BYTAG(Climbing);
+
+	const uint64 PhysStartCycles = FPlatformTime::Cycles64();
+
+	if (IsClimbing())
+	{
+		// 如果处于攀爬模式
+		PhysClimb(DeltaTime, Iterations);
+	}
+	else if (IsOnClimbPath())
+	{
+		// 如果处于攀爬路径模式
+		PhysClimbPath(DeltaTime, Iterations);
+	}
+	else if (IsLedgeHanging())
+	{
+		// 如果处于挂边模式
+		PhysLedgeHang(DeltaTime, Iterations);
+	}
+
+	ClimbWorkCycles += FPlatformTime::Cycles64() - PhysStartCycles;
+
+	Super::PhysCustom(DeltaTime, Iterations);
+}
+
+float UCustomMovementComponent::GetMaxSpeed() const
+{
+	if (IsClimbing())
+	{
+		// 如果处于攀爬模式，返回攀爬速度（按表面材质缩放）
+		return MaxClimbSpeed * CurrentClimbSurface.SpeedMultiplier;
+	}
+	if (IsOnClimbPath() && ActiveClimbPath)
+	{
+		// 如果处于攀爬路径模式，返回路径速度
+		return ActiveClimbPath->GetMaxPathSpeed();
+	}
+	if (IsLedgeHanging())
+	{
+		// 如果处于挂边模式，返回横移速度
+		return LedgeShimmySpeed;
+	}
+	return Super::GetMaxSpeed();
+}
+
+float UCustomMovementComponent::GetMaxAcceleration() const
+{
+	if (IsClimbing())
+	{
+		// 如果处于攀爬模式，返回攀爬加速度（按表面材质缩放）
+		return MaxClimbAcceleration * CurrentClimbSurface.AccelerationMultiplier;
+	}
+	if (IsOnClimbPath())
+	{
+		// 如果处于攀爬路径模式，返回路径加速度
+		return ClimbPathAcceleration;
+	}
+	return Super::GetMaxAcceleration();
+}
+
+FVector UCustomMovementComponent::ConstrainAnimRootMotionVelocity(const FVector& RootMotionVelocity, const FVector& CurrentVelocity) const
+{
+	// 这里之所以重写这个函数，是因为我们需要在攀爬模式下，限制根动作的速度，使角色在攀爬时不会因为根动作速度过大而脱离攀爬表面
+	// 同时，在父类中，这个函数会判断角色是否处于掉落状态，如果是，会将根动作速度限制为0，这样会导致角色在攀爬时无法播放根动作
+	if (IsFalling() && CharacterAnimInstance && CharacterAnimInstance->IsAnyMontagePlaying())
+	{
+		// 如果角色处于掉落状态，并且有动画蒙太奇正在播放
+		return RootMotionVelocity;
+	}
+	else
+	{
+		return Super::ConstrainAnimRootMotionVelocity(RootMotionVelocity, CurrentVelocity);
+	}
+}
+
+bool UCustomMovementComponent::TraceClimbableSurface()
+{
+	LLM_SCOPE_BYTAG(Climbing_Probes);
+	CLIMB_VLOG_PROBE_SCOPE("ClimbableSurface");
+
+	if (CanUseLandscapeFastPath() && TraceClimbableLandscape())
+	{
+		// 地形上直接采样高度场
+		return ResolveClimbSurfaceProperties();
+	}
+
+	const FVector StartOffset = UpdatedComponent->GetForwardVector() * 30.0f;
+	const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
+	const FVector End = Start + UpdatedComponent->GetForwardVector();
+
+	if (bTrackClimbSurfaceBones && TraceClimbableBoneBodies(Start, End))
+	{
+		// 在骨骼网格上攀爬，只扫描基座骨骼附近的物理体
+		return ResolveClimbSurfaceProperties();
+	}
+
+	if (bUseClimbDistanceField && TraceClimbableDistanceField())
+	{
+		// 距离场已经覆盖角色前方
+		return ResolveClimbSurfaceProperties();
+	}
+
+	ClimbableSurfaceTraceHits = DoCapsuleTraceMultiByObject(Start, End, bUseClimbSurfaceMaterials);
+
+	UpdateClimbLandscapeFromHits();
+
+	return ResolveClimbSurfaceProperties();
+}
+
+bool UCustomMovementComponent::ResolveClimbSurfaceProperties()
+{
+	if (!bUseClimbSurfaceMaterials)
+	{
+		CurrentClimbSurface = DefaultClimbSurface;
+		return !ClimbableSurfaceTraceHits.IsEmpty();
+	}
+
+	bool bHasClimbableHit = false;
+	FClimbSurfaceProperties CombinedSurface;
+	for (int32 Index = ClimbableSurfaceTraceHits.Num() - 1; Index >= 0; Index--)
+	{
+		const FClimbSurfaceProperties& HitSurface = ClimbSurfaceMaterials.Resolve(ClimbableSurfaceTraceHits[Index]);
+		if (!HitSurface.bClimbable)
+		{
+			// 不可攀爬的材质不参与表面拟合，保持命中顺序
+			ClimbableSurfaceTraceHits.RemoveAt(Index, 1, false);
+			continue;
+		}
+
+		if (bHasClimbableHit)
+		{
+			CombinedSurface.CombineMostRestrictive(HitSurface);
+		}
+		else
+		{
+			CombinedSurface = HitSurface;
+			bHasClimbableHit = true;
+		}
+	}
+
+	CurrentClimbSurface = bHasClimbableHit ? CombinedSurface : DefaultClimbSurface;
+	return bHasClimbableHit;
+}
+
+bool UCustomMovementComponent::UpdateClimbGrip(float DeltaTime)
+{
+	if (CurrentClimbSurface.GripLossTime <= 0.f)
+	{
+		// 不需要抓握的表面上恢复
+		ClimbGripTime = 0.f;
+		return false;
+	}
+
+	ClimbGripTime += DeltaTime;
+	return ClimbGripTime >= CurrentClimbSurface.GripLossTime;
+}
+
+bool UCustomMovementComponent::CanUseLandscapeFastPath() const
+{
+	return bEnableLandscapeFastPath
+		&& ClimbLandscape.IsValid()
+		&& GetWorld()->GetTimeSeconds() - LastFullClimbSweepTime < LandscapeFullSweepInterval;
+}
+
+void UCustomMovementComponent::UpdateClimbLandscapeFromHits()
+{
+	LastFullClimbSweepTime = GetWorld()->GetTimeSeconds();
+	ClimbLandscape.Reset();
+	ClimbLandscapeComponent.Reset();
+
+	if (!bEnableLandscapeFastPath || ClimbableSurfaceTraceHits.IsEmpty())
+	{
+		return;
+	}
+
+	// 只有所有命中都来自同一个地形时才使用快速路径，否则会漏掉地形上的其他物体
+	ALandscapeProxy* HitLandscape = Cast<ALandscapeProxy>(ClimbableSurfaceTraceHits[0].GetActor());
+	for (const FHitResult& Hit : ClimbableSurfaceTraceHits)
+	{
+		if (!HitLandscape || Hit.GetActor() != HitLandscape)
+		{
+			return;
+		}
+	}
+
+	ClimbLandscape = HitLandscape;
+	ClimbLandscapeComponent = ClimbableSurfaceTraceHits[0].GetComponent();
+}
+
+bool UCustomMovementComponent::TraceClimbableLandscape()
+{
+	const ALandscapeProxy* Landscape = ClimbLandscape.Get();
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
+	const FVector ComponentUp = UpdatedComponent->GetUpVector();
+
+	// 用胶囊体上、中、下三条射线近似胶囊体扫描的覆盖范围
+	const float TraceDistance = 30.f + ClimbCapsuleTraceRadius;
+	const float HeightOffsets[] = { -ClimbCapsuleTraceHalfHeight * 0.5f, 0.f, ClimbCapsuleTraceHalfHeight * 0.5f };
+
+	TArray<FHitResult> LandscapeHits;
+	for (const float HeightOffset : HeightOffsets)
+	{
+		const FVector Start = ComponentLocation + ComponentUp * HeightOffset;
+		const FVector End = Start + ComponentForward * TraceDistance;
+
+		FHitResult Hit;
+		const bool bHit = CS_ClimbLandscape::LineTrace(Landscape, ClimbLandscapeComponent.Get(), Start, End, Hit);
+		CLIMB_VLOG_LINE_TRACE(CharacterOwner, Start, End, Hit);
+		if (bHit)
+		{
+			LandscapeHits.Add(Hit);
+		}
+	}
+
+	if (LandscapeHits.IsEmpty())
+	{
+		// 离开地形或者前方没有地形，交给完整扫描处理
+		return false;
+	}
+
+	CS_ClimbMemory::NoteArray(LandscapeHits);
+	ClimbableSurfaceTraceHits = MoveTemp(LandscapeHits);
+	return true;
+}
+
+bool UCustomMovementComponent::CheckReachableLandscapeGround() const
+{
+	// 与胶囊体扫描的范围一致：从角色下方50.f开始，再往下一个检测胶囊体半高
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+
+	FVector GroundPoint;
+	FVector GroundNormal;
+	if (!CS_ClimbLandscape::SampleSurface(ClimbLandscape.Get(), ComponentLocation, GroundPoint, GroundNormal))
+	{
+		return false;
+	}
+
+	if (ComponentLocation.Z - 50.f - ClimbCapsuleTraceHalfHeight > GroundPoint.Z)
+	{
+		// 地面还在检测范围之外
+		return false;
+	}
+
+	return FVector::Parallel(-GroundNormal, FVector::UpVector, 0.1f)
+		&& GetUnRotatedClimbVelocity().Z < -10.f;
+}
+
+bool UCustomMovementComponent::CheckReachedLandscapeLedge(FHitResult& OutLedgeTopHit) const
+{
+	CLIMB_VLOG_PROBE_SCOPE("LandscapeLedge");
+
+	if (GetUnRotatedClimbVelocity().Z <= 10.f)
+	{
+		// 没有向上攀爬，不需要采样
+		return false;
+	}
+
+	const FVector ComponentUp = UpdatedComponent->GetUpVector();
+	const FVector EyeStart = UpdatedComponent->GetComponentLocation() + ComponentUp * (CharacterOwner->BaseEyeHeight + ClimbToTopTraceDistance);
+	const FVector EyeEnd = EyeStart + UpdatedComponent->GetForwardVector() * 100.f;
+
+	FHitResult EyeHeightHit;
+	if (CS_ClimbLandscape::LineTrace(ClimbLandscape.Get(), ClimbLandscapeComponent.Get(), EyeStart, EyeEnd, EyeHeightHit))
+	{
+		// 眼睛高度前方还有地形，还未到达顶端
+		return false;
+	}
+
+	// 前方100.f的位置向下100.f内有地面
+	return CS_ClimbLandscape::LineTrace(ClimbLandscape.Get(), ClimbLandscapeComponent.Get(), EyeEnd, EyeEnd - ComponentUp * 100.f, OutLedgeTopHit);
+}
+
+bool UCustomMovementComponent::TryStartClimbPath()
+{
+	if (IsClimbing() || IsOnClimbPath())
+	{
+		return false;
+	}
+
+	// 只查询胶囊体已有的重叠结果，不额外做物理检测
+	TArray<AActor*> OverlappingPaths;
+	CharacterOwner->GetOverlappingActors(OverlappingPaths, AClimbPathActor::StaticClass());
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+
+	AClimbPathActor* BestPath = nullptr;
+	float BestDistance = 0.f;
+	float BestDistanceSquared = TNumericLimits<float>::Max();
+	for (AActor* Actor : OverlappingPaths)
+	{
+		AClimbPathActor* ClimbPath = Cast<AClimbPathActor>(Actor);
+		if (!ClimbPath)
+		{
+			continue;
+		}
+
+		const float PathDistance = ClimbPath->FindDistanceClosestToWorldLocation(ComponentLocation);
+
+		FVector AttachLocation;
+		FQuat AttachRotation;
+		FVector SurfaceNormal;
+		ClimbPath->GetAttachTransformAtDistance(PathDistance, AttachLocation, AttachRotation, SurfaceNormal);
+
+		const float DistanceSquared = FVector::DistSquared(AttachLocation, ComponentLocation);
+		if (DistanceSquared <= FMath::Square(ClimbPath->GetEntryDistance()) && DistanceSquared < BestDistanceSquared)
+		{
+			BestPath = ClimbPath;
+			BestDistance = PathDistance;
+			BestDistanceSquared = DistanceSquared;
+		}
+	}
+
+	if (!BestPath)
+	{
+		return false;
+	}
+
+	FVector AttachLocation;
+	FQuat AttachRotation;
+	FVector SurfaceNormal;
+	BestPath->GetAttachTransformAtDistance(BestDistance, AttachLocation, AttachRotation, SurfaceNormal);
+
+	// 进入校验：附着位置不能被挡住
+	if (!IsCapsuleLocationFree(AttachLocation))
+	{
+		return false;
+	}
+
+	ActiveClimbPath = BestPath;
+	ClimbPathDistance = BestDistance;
+	ClimbPathSpeed = 0.f;
+	CurrentClimbableSurfaceLocation = AttachLocation;
+	CurrentClimbableSurfaceNormal = SurfaceNormal;
+
+	StopMovementImmediately();
+	SetMovementMode(MOVE_Custom, GetMovementModeForClimbPath(BestPath));
+	return true;
+}
+
+void UCustomMovementComponent::StopClimbPath()
+{
+	SetMovementMode(MOVE_Falling);
+}
+
+void UCustomMovementComponent::PhysClimbPath(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	if (!ActiveClimbPath)
+	{
+		// 路径被销毁
+		StopClimbPath();
+		return;
+	}
+
+	const float PathLength = ActiveClimbPath->GetPathLength();
+	const FVector PathDirection = ActiveClimbPath->GetDirectionAtDistance(ClimbPathDistance);
+	const float MaxPathSpeed = ActiveClimbPath->GetMaxPathSpeed();
+
+	if (ActiveClimbPath->GetPathType() == EClimbPathType::Zipline)
+	{
+		// 滑索：不接受输入，由重力沿路径方向加速
+		ClimbPathSpeed += FVector::DotProduct(FVector(0.f, 0.f, GetGravityZ()), PathDirection) * DeltaTime;
+		ClimbPathSpeed = FMath::Clamp(ClimbPathSpeed, -MaxPathSpeed, MaxPathSpeed);
+	}
+	else
+	{
+		// 输入（加速度）投影到路径方向上
+		const float InputAlongPath = FVector::DotProduct(Acceleration.GetSafeNormal(), PathDirection);
+		if (FMath::Abs(InputAlongPath) > KINDA_SMALL_NUMBER)
+		{
+			ClimbPathSpeed = FMath::Clamp(ClimbPathSpeed + InputAlongPath * ClimbPathAcceleration * DeltaTime, -MaxPathSpeed, MaxPathSpeed);
+		}
+		else
+		{
+			ClimbPathSpeed = FMath::FInterpConstantTo(ClimbPathSpeed, 0.f, DeltaTime, ClimbPathBrakingDeceleration);
+		}
+	}
+
+	if (HasAnimRootMotion())
+	{
+		// 根动作期间（例如进入/离开动画）不沿路径移动
+		ClimbPathSpeed = 0.f;
+	}
+
+	ClimbPathDistance += ClimbPathSpeed * DeltaTime;
+
+	if (ClimbPathDistance <= 0.f || ClimbPathDistance >= PathLength)
+	{
+		// 到达端点，尝试离开路径，否则停在端点
+		const bool bAtEnd = ClimbPathDistance >= PathLength;
+		ClimbPathDistance = FMath::Clamp(ClimbPathDistance, 0.f, PathLength);
+
+		if (TryExitClimbPathAtEnd(bAtEnd))
+		{
+			return;
+		}
+
+		ClimbPathSpeed = 0.f;
+	}
+
+	FVector AttachLocation;
+	FQuat AttachRotation;
+	FVector SurfaceNormal;
+	ActiveClimbPath->GetAttachTransformAtDistance(ClimbPathDistance, AttachLocation, AttachRotation, SurfaceNormal);
+
+	CurrentClimbableSurfaceLocation = AttachLocation;
+	CurrentClimbableSurfaceNormal = SurfaceNormal;
+
+	// 路径由关卡设计保证可通行，这里直接移动，不做扫描
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat NewRotation = FQuat::Slerp(UpdatedComponent->GetComponentQuat(), AttachRotation, FMath::Min(DeltaTime * 10.f, 1.f));
+	MoveUpdatedComponent(AttachLocation - OldLocation, NewRotation, false);
+
+	Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / DeltaTime;
+}
+
+bool UCustomMovementComponent::TryExitClimbPathAtEnd(bool bAtEnd)
+{
+	const float InputAlongPath = FVector::DotProduct(Acceleration.GetSafeNormal(), ActiveClimbPath->GetDirectionAtDistance(ClimbPathDistance));
+	const bool bPushingOut = ActiveClimbPath->GetPathType() == EClimbPathType::Zipline || (bAtEnd ? InputAlongPath > 0.f : InputAlongPath < 0.f);
+	if (!bPushingOut)
+	{
+		return false;
+	}
+
+	FVector ExitLocation;
+	if (ActiveClimbPath->GetExitLocation(bAtEnd, ExitLocation))
+	{
+		// 离开校验：离开位置不能被挡住
+		if (!IsCapsuleLocationFree(ExitLocation))
+		{
+			return false;
+		}
+
+		const FRotator CleanRotation(0.f, UpdatedComponent->GetComponentRotation().Yaw, 0.f);
+		UpdatedComponent->SetWorldLocationAndRotation(ExitLocation, CleanRotation, false, nullptr, ETeleportType::TeleportPhysics);
+		SetMovementMode(MOVE_Walking);
+		return true;
+	}
+
+	if (!bAtEnd || ActiveClimbPath->GetPathType() == EClimbPathType::Zipline)
+	{
+		// 没有配置离开位置的底端或者滑索终点直接松手
+		StopClimbPath();
+		return true;
+	}
+
+	return false;
+}
+
+bool UCustomMovementComponent::IsCapsuleLocationFree(const FVector& TestLocation) const
+{
+	const FCollisionShape CapsuleShape = CharacterOwner->GetCapsuleComponent()->GetCollisionShape();
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbCapsuleLocationFree), false, CharacterOwner);
+	FCollisionResponseParams ResponseParams;
+	InitCollisionParams(QueryParams, ResponseParams);
+
+	return !GetWorld()->OverlapBlockingTestByChannel(TestLocation, FQuat::Identity, UpdatedComponent->GetCollisionObjectType(), CapsuleShape, QueryParams, ResponseParams);
+}
+
+ECustomMovementMode::Type UCustomMovementComponent::GetMovementModeForClimbPath(const AClimbPathActor* ClimbPath)
+{
+	switch (ClimbPath->GetPathType())
+	{
+	case EClimbPathType::Rope:
+		return ECustomMovementMode::MOVE_Rope;
+	case EClimbPathType::Pipe:
+		return ECustomMovementMode::MOVE_Pipe;
+	case EClimbPathType::Zipline:
+		return ECustomMovementMode::MOVE_Zipline;
+	case EClimbPathType::Ladder:
+	default:
+		return ECustomMovementMode::MOVE_Ladder;
+	}
+}
+
+void UCustomMovementComponent::UpdateClimbDistanceField()
+{
+	LLM_SCOPE_BYTAG(Climbing_DistanceField);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ClimbDistanceFieldBrick), false, CharacterOwner);
+
+	ClimbDistanceField.Update(ClimbTraceContext, UpdatedComponent->GetComponentLocation(), ClimbDistanceFieldRadius, QueryParams, ClimbDistanceFieldBricksPerFrame, ClimbDistanceFieldSamplesPerFrame);
+}
+
+bool UCustomMovementComponent::TraceClimbableDistanceField()
+{
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector ComponentForward = UpdatedComponent->GetForwardVector();
+	const FVector ComponentUp = UpdatedComponent->GetUpVector();
+
+	// 和地形快速路径一样，用胶囊体上、中、下三条射线近似胶囊体扫描
+	const float TraceDistance = 30.f + ClimbCapsuleTraceRadius;
+	const float HeightOffsets[] = { -ClimbCapsuleTraceHalfHeight * 0.5f, 0.f, ClimbCapsuleTraceHalfHeight * 0.5f };
+
+	TArray<FHitResult> DistanceFieldHits;
+	for (const float HeightOffset : HeightOffsets)
+	{
+		const FVector Start = ComponentLocation + ComponentUp * HeightOffset;
+		const FVector End = Start + ComponentForward * TraceDistance;
+
+		FHitResult Hit;
+		if (!ClimbDistanceField.LineTrace(Start, End, Hit))
+		{
+			// 距离场还没有覆盖这条射线
+			return false;
+		}
+		CLIMB_VLOG_LINE_TRACE(CharacterOwner, Start, End, Hit);
+
+		if (Hit.bBlockingHit)
+		{
+			DistanceFieldHits.Add(Hit);
+		}
+	}
+
+	CS_ClimbMemory::NoteArray(DistanceFieldHits);
+	ClimbableSurfaceTraceHits = MoveTemp(DistanceFieldHits);
+	return true;
+}
+
+bool UCustomMovementComponent::TraceWithClimbDistanceField(const FVector& Start, const FVector& End, FHitResult& OutHit) const
+{
+	if (!bUseClimbDistanceField || !IsClimbing())
+	{
+		return false;
+	}
+
+	if (!ClimbDistanceField.LineTrace(Start, End, OutHit))
+	{
+		return false;
+	}
+
+	CLIMB_VLOG_LINE_TRACE(CharacterOwner, Start, End, OutHit);
+	return true;
+}
+
+bool UCustomMovementComponent::TryStartLedgeHang(const FHitResult& LedgeTopHit)
+{
+	FClimbLedgeSegment NewSegment;
+	if (!ExtractLedgeSegment(CurrentClimbableSurfaceLocation, CurrentClimbableSurfaceNormal, LedgeTopHit, NewSegment))
+	{
+		return false;
+	}
+
+	LedgeSegment = NewSegment;
+	LedgeHangDistance = FMath::Clamp(FVector::DotProduct(UpdatedComponent->GetComponentLocation() - LedgeSegment.Start, LedgeSegment.GetDirection()), 0.f, LedgeSegment.Length);
+	FailedLedgeChainDirection = 0.f;
+
+	SetMovementMode(MOVE_Custom, ECustomMovementMode::MOVE_LedgeHang);
+
+	// 挂边时攀爬输入使用墙面法线计算方向
+	CurrentClimbableSurfaceNormal = LedgeSegment.WallNormal;
+	CurrentClimbableSurfaceLocation = LedgeSegment.GetPointAt(LedgeHangDistance);
+	return true;
+}
+
+bool UCustomMovementComponent::ExtractLedgeSegment(const FVector& WallPoint, const FVector& WallNormal, const FHitResult& LedgeTopHit, FClimbLedgeSegment& OutSegment) const
+{
+	const FVector WallNormal2D = WallNormal.GetSafeNormal2D();
+	const FVector EdgeDirection = FVector::CrossProduct(FVector::UpVector, WallNormal2D).GetSafeNormal();
+	if (WallNormal2D.IsNearlyZero() || EdgeDirection.IsNearlyZero())
+	{
+		return false;
+	}
+
+	// 边缘线：墙面上与顶面同高，离角色最近的点
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	FVector EdgePoint = ComponentLocation - WallNormal2D * FVector::DotProduct(ComponentLocation - WallPoint, WallNormal2D);
+	EdgePoint.Z = LedgeTopHit.ImpactPoint.Z;
+
+	float MinDistance = -MaxLedgeSegmentHalfLength;
+	float MaxDistance = MaxLedgeSegmentHalfLength;
+
+	// 用顶面组件的本地包围盒裁剪边缘线，得到线段两端
+	if (const UPrimitiveComponent* LedgeComponent = LedgeTopHit.GetComponent())
+	{
+		const FTransform& ComponentTransform = LedgeComponent->GetComponentTransform();
+		const FBox LocalBounds = LedgeComponent->CalcBounds(FTransform::Identity).GetBox();
+		const FVector LocalOrigin = ComponentTransform.InverseTransformPosition(EdgePoint);
+		const FVector LocalDirection = ComponentTransform.InverseTransformVector(EdgeDirection);
+
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			if (FMath::IsNearlyZero(LocalDirection[Axis]))
+			{
+				continue;
+			}
+
+			const float T0 = (LocalBounds.Min[Axis] - LocalOrigin[Axis]) / LocalDirection[Axis];
+			const float T1 = (LocalBounds.Max[Axis] - LocalOrigin[Axis]) / LocalDirection[Axis];
+			MinDistance = FMath::Max(MinDistance, FMath::Min(T0, T1));
+			MaxDistance = FMath::Min(MaxDistance, FMath::Max(T0, T1));
+		}
+	}
+
+	if (MaxDistance <= MinDistance)
+	{
+		return false;
+	}
+
+	OutSegment.Start = EdgePoint + EdgeDirection * MinDistance;
+	OutSegment.End = EdgePoint + EdgeDirection * MaxDistance;
+	OutSegment.WallNormal = WallNormal2D;
+	OutSegment.Length = MaxDistance - MinDistance;
+
+	CLIMB_VLOG_SEGMENT(CharacterOwner, "LedgeSegment", OutSegment.Start, OutSegment.End, FColor::Blue);
+	return true;
+}
+
+FVector UCustomMovementComponent::GetLedgeHangLocation(float Distance) const
+{
+	return LedgeSegment.GetPointAt(Distance) + LedgeSegment.WallNormal * LedgeHangWallOffset - FVector::UpVector * LedgeHangVerticalOffset;
+}
+
+void UCustomMovementComponent::PhysLedgeHang(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	if (HasAnimRootMotion())
+	{
+		// 上墙蒙太奇由根动作驱动
+		RestorePreAdditiveRootMotionVelocity();
+		ApplyRootMotionToVelocity(DeltaTime);
+
+		FHitResult Hit(1.f);
+		SafeMoveUpdatedComponent(Velocity * DeltaTime, UpdatedComponent->GetComponentQuat(), true, Hit);
+		return;
+	}
+
+	const FVector InputDirection = Acceleration.GetSafeNormal();
+	const float VerticalInput = FVector::DotProduct(InputDirection, FVector::UpVector);
+	const float LateralInput = FVector::DotProduct(InputDirection, LedgeSegment.GetDirection());
+
+	if (VerticalInput > 0.7f)
+	{
+		// 向上：爬上边缘
+		PlayClimbMontage(AnimMontage_ClimbToTop);
+		RecordClimbTelemetry(EClimbTelemetryEvent::TopOut);
+		return;
+	}
+
+	if (VerticalInput < -0.7f)
+	{
+		// 向下：回到攀爬
+		StartClimbing();
+		return;
+	}
+
+	const float OldDistance = LedgeHangDistance;
+	LedgeHangDistance += LateralInput * LedgeShimmySpeed * DeltaTime;
+
+	if (LedgeHangDistance < 0.f || LedgeHangDistance > LedgeSegment.Length)
+	{
+		// 到达端点：只在这里检测相邻的边缘
+		const float Direction = LedgeHangDistance < 0.f ? -1.f : 1.f;
+		if (!TryChainLedgeSegment(Direction))
+		{
+			LedgeHangDistance = FMath::Clamp(LedgeHangDistance, 0.f, LedgeSegment.Length);
+		}
 	}
 
-	if (OutVaultStartLocation != FVector::ZeroVector && OutVaultLandLocation != FVector::ZeroVector)
+	if (FailedLedgeChainDirection != 0.f && LedgeHangDistance != OldDistance && FMath::Sign(LedgeHangDistance - OldDistance) != FailedLedgeChainDirection)
 	{
-		// 如果检测到翻越起点和终点，返回true
-		return true;
+		// 反向移动后允许再次检测
+		FailedLedgeChainDirection = 0.f;
 	}
 
-	return false;
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat TargetRotation = FRotationMatrix::MakeFromX(-LedgeSegment.WallNormal).ToQuat();
+	const FQuat NewRotation = FQuat::Slerp(UpdatedComponent->GetComponentQuat(), TargetRotation, FMath::Min(DeltaTime * 10.f, 1.f));
 
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(GetLedgeHangLocation(LedgeHangDistance) - OldLocation, NewRotation, true, Hit);
+
+	Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / DeltaTime;
+	CurrentClimbableSurfaceLocation = LedgeSegment.GetPointAt(LedgeHangDistance);
 }
 
-void UCustomMovementComponent::SetMotionWarpingTarget(const FName& TargetSectionName, const FVector& TargetLocation) const
+bool UCustomMovementComponent::TryChainLedgeSegment(float Direction)
 {
-	if (ClimbingSystemCharacter)
+	CLIMB_VLOG_PROBE_SCOPE("LedgeChain");
+
+	if (FailedLedgeChainDirection == Direction)
 	{
-		ClimbingSystemCharacter->GetMotionWarpingComponent()->AddOrUpdateWarpTargetFromLocation(TargetSectionName, TargetLocation);
+		// 这个方向已经检测过，没有相邻边缘
+		return false;
 	}
-}
 
-void UCustomMovementComponent::HandleClimbDashUp()
-{
-	FVector TargetPoint = FVector::ZeroVector;
-	if (CheckClimbDashUp(TargetPoint))
+	const FVector EdgeDirection = LedgeSegment.GetDirection() * Direction;
+	const FVector Endpoint = Direction > 0.f ? LedgeSegment.End : LedgeSegment.Start;
+	const FVector ProbeEdgePoint = Endpoint + EdgeDirection * LedgeChainProbeDistance;
+
+	// 墙面：从挂边位置外侧朝墙检测
+	const FVector WallTraceStart = ProbeEdgePoint + LedgeSegment.WallNormal * LedgeHangWallOffset * 2.f - FVector::UpVector * LedgeChainHeightTolerance;
+	const FVector WallTraceEnd = WallTraceStart - LedgeSegment.WallNormal * LedgeHangWallOffset * 3.f;
+	const FHitResult WallHit = DoLineTraceSingleByObject(WallTraceStart, WallTraceEnd);
+
+	// 顶面：在边缘内侧向下检测
+	const FVector TopTraceStart = ProbeEdgePoint - LedgeSegment.WallNormal * LedgeChainProbeDistance + FVector::UpVector * LedgeChainHeightTolerance;
+	const FVector TopTraceEnd = TopTraceStart - FVector::UpVector * LedgeChainHeightTolerance * 2.f;
+	const FHitResult TopHit = DoLineTraceSingleByObject(TopTraceStart, TopTraceEnd);
+
+	FClimbLedgeSegment NewSegment;
+	if (!WallHit.bBlockingHit || !TopHit.bBlockingHit
+		|| !IsClimbableSurfaceNormal(WallHit.ImpactNormal)
+		|| !ExtractLedgeSegment(WallHit.ImpactPoint, WallHit.ImpactNormal, TopHit, NewSegment))
 	{
-		SetMotionWarpingTarget("DashUpTargetPoint", TargetPoint);
-		// 如果可以攀爬冲刺上
-		PlayClimbMontage(AnimMontage_ClimbDashUp);
+		FailedLedgeChainDirection = Direction;
+		return false;
 	}
+
+	// 切换到新线段，保持角色位置连续
+	const FVector CurrentEdgePoint = LedgeSegment.GetPointAt(LedgeHangDistance);
+	LedgeSegment = NewSegment;
+	LedgeHangDistance = FMath::Clamp(FVector::DotProduct(CurrentEdgePoint + EdgeDirection * LedgeChainProbeDistance - LedgeSegment.Start, LedgeSegment.GetDirection()), 0.f, LedgeSegment.Length);
+	CurrentClimbableSurfaceNormal = LedgeSegment.WallNormal;
+	FailedLedgeChainDirection = 0.f;
+	return true;
 }
 
-bool UCustomMovementComponent::CheckClimbDashUp(FVector& OutTargetPoint)
+bool UCustomMovementComponent::CheckPredictedLedge(FHitResult& OutLedgeTopHit)
 {
-	OutTargetPoint = FVector::ZeroVector;
+	const FVector ComponentUp = UpdatedComponent->GetUpVector();
+	const float ClimbUpSpeed = FVector::DotProduct(Velocity, ComponentUp);
+	if (ClimbUpSpeed <= 10.f)
+	{
+		// 没有向上攀爬
+		return false;
+	}
 
-	if (IsFalling())
+	const float EyeHeight = FVector::DotProduct(UpdatedComponent->GetComponentLocation(), ComponentUp) + CharacterOwner->BaseEyeHeight + ClimbToTopTraceDistance;
+	if (!IsTopOutPredictionValid() || (!TopOutPrediction.bHasLedge && EyeHeight > TopOutPrediction.ValidUntilHeight))
+	{
+		// 偏离了预测，或者已经超出了上一次预测的范围
+		UpdateTopOutPrediction();
+	}
+
+	if (!TopOutPrediction.bHasLedge)
 	{
-		// 如果正在下落，不允许攀爬冲刺上
 		return false;
 	}
 
-	FHitResult HitResult = TraceFromEyeHeight(100.f, -30.f, false, true);
-	FHitResult SaftyLedgeHitResult = TraceFromEyeHeight(100.f, 150.f, false, true);
-	if (HitResult.bBlockingHit && SaftyLedgeHitResult.bBlockingHit)
+	// 外推蒙太奇提前时间后的眼睛高度，超过顶端时立即开始上墙
+	const float PredictedEyeHeight = EyeHeight + ClimbUpSpeed * GetTopOutLeadTime();
+	if (PredictedEyeHeight < TopOutPrediction.LedgeHeight)
 	{
-		// 如果检测到阻挡，并且检测到安全的突出物，允许攀爬冲刺上
-		OutTargetPoint = HitResult.ImpactPoint;
-		return true;
+		return false;
 	}
 
-	return false;
+	OutLedgeTopHit = TopOutPrediction.LedgeTopHit;
+	TopOutPrediction.bValid = false;
+	return true;
 }
 
-void UCustomMovementComponent::HandleClimbDashDown()
+void UCustomMovementComponent::UpdateTopOutPrediction()
 {
-	FVector TargetPoint = FVector::ZeroVector;
-	if (CheckClimbDashDown(TargetPoint))
+	CLIMB_VLOG_PROBE_SCOPE("TopOutPrediction");
+
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	const FVector ComponentUp = UpdatedComponent->GetUpVector();
+	const FVector EyeLocation = ComponentLocation + ComponentUp * (CharacterOwner->BaseEyeHeight + ClimbToTopTraceDistance);
+	const FVector LedgeProbeLocation = EyeLocation + UpdatedComponent->GetForwardVector() * 100.f;
+
+	TopOutPrediction.bValid = true;
+	TopOutPrediction.bHasLedge = false;
+	TopOutPrediction.Origin = ComponentLocation;
+	TopOutPrediction.UpVector = ComponentUp;
+	TopOutPrediction.WallNormal = CurrentClimbableSurfaceNormal;
+
+	// 与 CheckReachedLedge 相同：前方100.f的位置向下100.f内有地面，这里从眼睛上方开始一次检测
+	const FVector Start = LedgeProbeLocation + ComponentUp * TopOutLookaheadDistance;
+	const FVector End = LedgeProbeLocation - ComponentUp * 100.f;
+	const FHitResult LedgeTopHit = DoLineTraceSingleByObject(Start, End);
+
+	const float EyeHeight = FVector::DotProduct(EyeLocation, ComponentUp);
+	if (!LedgeTopHit.bBlockingHit || LedgeTopHit.bStartPenetrating
+		|| FVector::DotProduct(LedgeTopHit.ImpactNormal, ComponentUp) < GetWalkableFloorZ())
 	{
-		SetMotionWarpingTarget("DashDownTargetPoint", TargetPoint);
-		// 如果可以攀爬冲刺下
-		PlayClimbMontage(AnimMontage_ClimbDashDown);
+		// 范围内没有顶端，眼睛超过范围的一半之前不需要重新检测
+		TopOutPrediction.ValidUntilHeight = EyeHeight + TopOutLookaheadDistance * 0.5f;
+		return;
 	}
+
+	CLIMB_VLOG_SURFACE(CharacterOwner, "PredictedTopOut", LedgeTopHit.ImpactPoint, LedgeTopHit.ImpactNormal);
+
+	TopOutPrediction.bHasLedge = true;
+	TopOutPrediction.LedgeHeight = FVector::DotProduct(LedgeTopHit.ImpactPoint, ComponentUp);
+	TopOutPrediction.LedgeTopHit = LedgeTopHit;
 }
 
-bool UCustomMovementComponent::CheckClimbDashDown(FVector& OutTargetPoint)
+bool UCustomMovementComponent::IsTopOutPredictionValid() const
 {
-	OutTargetPoint = FVector::ZeroVector;
-
-	if (IsFalling())
+	if (!TopOutPrediction.bValid)
 	{
-		// 如果正在下落，不允许攀爬冲刺下
 		return false;
 	}
 
-	FHitResult HitResult = TraceFromEyeHeight(100.f, -300.f, false, true);
-	if (HitResult.bBlockingHit)
+	if (FVector::DotProduct(TopOutPrediction.WallNormal, CurrentClimbableSurfaceNormal) < 0.95f
+		|| FVector::DotProduct(TopOutPrediction.UpVector, UpdatedComponent->GetUpVector()) < 0.95f)
 	{
-		// 如果检测到阻挡，允许攀爬冲刺下
-		OutTargetPoint = HitResult.ImpactPoint;
-		return true;
+		// 墙面或者角色朝向发生了变化
+		return false;
 	}
 
-	return false;
+	// 只关心沿墙面的横向偏移，向上或向下移动不影响顶端的位置
+	const FVector Offset = UpdatedComponent->GetComponentLocation() - TopOutPrediction.Origin;
+	const FVector LateralOffset = FVector::VectorPlaneProject(Offset, TopOutPrediction.UpVector);
+	return LateralOffset.SizeSquared() <= FMath::Square(TopOutDeviationTolerance);
 }
 
-void UCustomMovementComponent::HandleClimbDashLeft()
+float UCustomMovementComponent::GetTopOutLeadTime() const
 {
-	FVector TargetPoint = FVector::ZeroVector;
-	if (CheckClimbDashLeft(TargetPoint))
+	if (TopOutLeadTime > 0.f)
 	{
-		SetMotionWarpingTarget("DashLeftTargetPoint", TargetPoint);
-		// 如果可以攀爬冲刺左
-		PlayClimbMontage(AnimMontage_ClimbDashLeft);
+		return TopOutLeadTime;
 	}
+
+	return AnimMontage_ClimbToTop ? AnimMontage_ClimbToTop->BlendIn.GetBlendTime() : 0.f;
 }
 
-bool UCustomMovementComponent::CheckClimbDashLeft(FVector& OutTargetPoint)
+EClimbTraversalState UCustomMovementComponent::ResolveClimbTraversalState() const
 {
-	OutTargetPoint = FVector::ZeroVector;
+	if (CharacterAnimInstance)
+	{
+		const EClimbTraversalState MontageState = GetTraversalStateForMontage(CharacterAnimInstance->GetCurrentActiveMontage());
+		if (MontageState != EClimbTraversalState::MAX)
+		{
+			// 攀爬蒙太奇优先于移动模式
+			return MontageState;
+		}
+	}
+
+	if (IsClimbing() || IsOnClimbPath() || IsLedgeHanging())
+	{
+		return EClimbTraversalState::Climbing;
+	}
 
 	if (IsFalling())
 	{
-		// 如果正在下落，不允许攀爬冲刺左
-		return false;
+		return EClimbTraversalState::Dropping;
 	}
 
-	FHitResult HitResult = TraceFromEyeHeight_V(100.f, -200.f, false, true);
-	if (HitResult.bBlockingHit)
+	if (Velocity.SizeSquared2D() > FMath::Square(10.f) && !(CharacterAnimInstance && CharacterAnimInstance->IsAnyMontagePlaying()))
 	{
-		// 如果检测到阻挡，允许攀爬冲刺左
-		OutTargetPoint = HitResult.ImpactPoint;
-		return true;
+		// 地面移动并且没有其他蒙太奇在播放
+		return EClimbTraversalState::Approaching;
 	}
 
-	return false;
+	return EClimbTraversalState::Idle;
 }
 
-void UCustomMovementComponent::HandleClimbDashRight()
+EClimbTraversalState UCustomMovementComponent::GetTraversalStateForMontage(const UAnimMontage* Montage) const
 {
-	FVector TargetPoint = FVector::ZeroVector;
-	if (CheckClimbDashRight(TargetPoint))
+	if (!Montage)
+	{
+		return EClimbTraversalState::MAX;
+	}
+
+	if (Montage == AnimMontage_StandToWallUp || Montage == AnimMontage_ClimbToDown)
+	{
+		return EClimbTraversalState::Mounting;
+	}
+	if (Montage == AnimMontage_ClimbToTop)
+	{
+		return EClimbTraversalState::ToppingOut;
+	}
+	if (Montage == AnimMontage_Vaulting)
+	{
+		return EClimbTraversalState::Vaulting;
+	}
+	if (IsClimbDashMontage(Montage))
 	{
-		SetMotionWarpingTarget("DashRightTargetPoint", TargetPoint);
-		// 如果可以攀爬冲刺右
-		PlayClimbMontage(AnimMontage_ClimbDashRight);
+		return EClimbTraversalState::Dashing;
 	}
+	return EClimbTraversalState::MAX;
 }
 
-bool UCustomMovementComponent::CheckClimbDashRight(FVector& OutTargetPoint)
+void UCustomMovementComponent::GetClimbMemoryUsage(FClimbMemoryUsage& OutUsage) const
 {
-	OutTargetPoint = FVector::ZeroVector;
+	OutUsage = FClimbMemoryUsage();
 
-	if (IsFalling())
+	OutUsage.ComponentState = GetClass()->GetStructureSize()
+		+ ClimbTraceObjectTypes.GetAllocatedSize()
+		+ ClimbSurfaceMaterials.GetAllocatedSize()
+		+ WallJumpPitchAngles.GetAllocatedSize();
+
+	OutUsage.TraceHits = ClimbableSurfaceTraceHits.GetAllocatedSize();
+
+	OutUsage.DashData = ClimbDashDirections.GetAllocatedSize() + ClimbDashTrajectories.GetAllocatedSize();
+	for (const TPair<const UAnimMontage*, FClimbDashTrajectory>& Pair : ClimbDashTrajectories)
 	{
-		// 如果正在下落，不允许攀爬冲刺右
-		return false;
+		OutUsage.DashData += Pair.Value.Points.GetAllocatedSize();
 	}
 
-	FHitResult HitResult = TraceFromEyeHeight_V(100.f, 200.f, false, true);
-	if (HitResult.bBlockingHit)
+	OutUsage.DistanceField = ClimbDistanceField.GetAllocatedSize();
+
+	if (ClimbingSystemCharacter && ClimbingSystemCharacter->GetMotionWarpingComponent())
 	{
-		// 如果检测到阻挡，允许攀爬冲刺右
-		OutTargetPoint = HitResult.ImpactPoint;
-		return true;
+		// 运动扭曲组件没有重写 GetResourceSizeBytes，组件本身和攀爬设置的扭曲目标逐个统计
+		const UMotionWarpingComponent* MotionWarping = ClimbingSystemCharacter->GetMotionWarpingComponent();
+		OutUsage.MotionWarping = MotionWarping->GetClass()->GetStructureSize() + ClimbWarpTargetNames.GetAllocatedSize();
+		for (const FName& TargetName : ClimbWarpTargetNames)
+		{
+			if (MotionWarping->FindWarpTarget(TargetName))
+			{
+				OutUsage.MotionWarping += sizeof(FMotionWarpingTarget);
+			}
+		}
 	}
-
-	return false;
 }
 
-void UCustomMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+void UCustomMovementComponent::GetClimbMontages(TSet<const UAnimMontage*>& OutMontages) const
 {
+	const UAnimMontage* Montages[] = {
+		AnimMontage_StandToWallUp, AnimMontage_ClimbToTop, AnimMontage_ClimbToDown, AnimMontage_Vaulting,
+		AnimMontage_ClimbDashUp, AnimMontage_ClimbDashDown, AnimMontage_ClimbDashLeft, AnimMontage_ClimbDashRight };
 
-	if (IsClimbing())
+	for (const UAnimMontage* Montage : Montages)
 	{
-		// 如果进入攀爬模式
-		bOrientRotationToMovement = false;	// 不根据移动方向旋转角色
-		CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(CharacterCapsuleHalfHeight/2.f);	// 设置胶囊体高度
+		if (Montage)
+		{
+			OutMontages.Add(Montage);
+		}
+	}
 
-		OnEnterClimbState_Delegate.ExecuteIfBound();	// 触发进入攀爬状态委托
+	for (const FClimbDashDirection& DashDirection : ClimbDashDirections)
+	{
+		if (DashDirection.Montage)
+		{
+			OutMontages.Add(DashDirection.Montage);
+		}
 	}
-	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == ECustomMovementMode::MOVE_Climb)
+}
+
+void UCustomMovementComponent::RecordClimbSnapshot(float DeltaTime)
+{
+	if (bResimulatingClimb)
 	{
-		// 如果离开攀爬模式
-		bOrientRotationToMovement = true;	// 根据移动方向旋转角色
-		CharacterOwner->GetCapsuleComponent()->SetCapsuleHalfHeight(CharacterCapsuleHalfHeight);	// 恢复胶囊体高度
+		return;
+	}
 
-		// 重置角色旋转，只保留Yaw旋转，Pitch和Roll重置为0，因为在攀爬模式下，角色的Pitch和Roll会因为身体紧贴墙面导致发生变化
-		const FRotator DirtyRotation = UpdatedComponent->GetComponentRotation();
-		const FRotator CleanRotation = FRotator(0.f, DirtyRotation.Yaw, 0.f);		// 重置角色旋转
-		UpdatedComponent->SetRelativeRotation(CleanRotation);		// 设置角色旋转
+	ClimbSimFrame++;
 
-		StopMovementImmediately();		// 停止移动
+	FClimbSnapshot& Snapshot = ClimbSnapshots.Push();
+	SaveClimbSnapshot(Snapshot);
+	Snapshot.Frame = ClimbSimFrame;
+	Snapshot.DeltaTime = DeltaTime;
+}
 
-		OnExitClimbState_Delegate.ExecuteIfBound();	// 触发退出攀爬状态委托
+void UCustomMovementComponent::SaveClimbSnapshot(FClimbSnapshot& OutSnapshot) const
+{
+	OutSnapshot.Acceleration = Acceleration;
+
+	OutSnapshot.MovementMode = MovementMode;
+	OutSnapshot.CustomMovementMode = CustomMovementMode;
+	OutSnapshot.Location = UpdatedComponent->GetComponentLocation();
+	OutSnapshot.Rotation = UpdatedComponent->GetComponentQuat();
+	OutSnapshot.Velocity = Velocity;
+
+	OutSnapshot.SurfaceLocation = CurrentClimbableSurfaceLocation;
+	OutSnapshot.SurfaceNormal = CurrentClimbableSurfaceNormal;
+	OutSnapshot.NumSurfaceHits = FMath::Min(ClimbableSurfaceTraceHits.Num(), FClimbSnapshot::MaxSurfaceHits);
+	for (int32 Index = 0; Index < OutSnapshot.NumSurfaceHits; Index++)
+	{
+		const FHitResult& Hit = ClimbableSurfaceTraceHits[Index];
+		OutSnapshot.SurfaceHitPoints[Index] = Hit.ImpactPoint;
+		OutSnapshot.SurfaceHitNormals[Index] = Hit.ImpactNormal;
+		OutSnapshot.SurfaceHitComponents[Index] = Hit.GetComponent();
 	}
+	OutSnapshot.SurfaceProperties = CurrentClimbSurface;
+	OutSnapshot.GripTime = ClimbGripTime;
 
-	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
-}
+	UAnimMontage* CurrentMontage = CharacterAnimInstance ? CharacterAnimInstance->GetCurrentActiveMontage() : nullptr;
+	OutSnapshot.Montage = CurrentMontage;
+	OutSnapshot.MontagePosition = CurrentMontage ? CharacterAnimInstance->Montage_GetPosition(CurrentMontage) : 0.f;
+	OutSnapshot.MontagePlayRate = CurrentMontage ? CharacterAnimInstance->Montage_GetPlayRate(CurrentMontage) : 1.f;
+	OutSnapshot.OpenClimbWindows = OpenClimbWindows;
 
-void UCustomMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
-{
-	if (IsClimbing())
+	OutSnapshot.NumWarpTargets = 0;
+	if (ClimbingSystemCharacter && ClimbingSystemCharacter->GetMotionWarpingComponent())
 	{
-		// 如果处于攀爬模式
-		PhysClimb(DeltaTime, Iterations);
+		const UMotionWarpingComponent* MotionWarping = ClimbingSystemCharacter->GetMotionWarpingComponent();
+		for (const FName& TargetName : ClimbWarpTargetNames)
+		{
+			if (const FMotionWarpingTarget* Target = MotionWarping->FindWarpTarget(TargetName))
+			{
+				const int32 Index = OutSnapshot.NumWarpTargets++;
+				OutSnapshot.WarpTargetNames[Index] = TargetName;
+				OutSnapshot.WarpTargetLocations[Index] = Target->Location;
+				OutSnapshot.WarpTargetRotations[Index] = Target->Rotation.Quaternion();
+			}
+		}
 	}
 
-	Super::PhysCustom(DeltaTime, Iterations);
+	OutSnapshot.CornerTransition = CornerTransition;
+	OutSnapshot.LedgeSegment = LedgeSegment;
+	OutSnapshot.LedgeHangDistance = LedgeHangDistance;
+	OutSnapshot.ClimbPath = ActiveClimbPath;
+	OutSnapshot.ClimbPathDistance = ClimbPathDistance;
+	OutSnapshot.ClimbPathSpeed = ClimbPathSpeed;
+	OutSnapshot.WallJumpTarget = WallJumpTarget;
 }
 
-float UCustomMovementComponent::GetMaxSpeed() const
+void UCustomMovementComponent::RestoreClimbSnapshot(const FClimbSnapshot& Snapshot)
 {
-	if (IsClimbing())
+	TGuardValue<bool> RestoreGuard(bRestoringClimbSnapshot, true);
+
+	if (MovementMode != Snapshot.MovementMode || CustomMovementMode != Snapshot.CustomMovementMode)
 	{
-		// 如果处于攀爬模式，返回攀爬速度
-		return MaxClimbSpeed;
+		// 先切换模式，模式切换中的重置会被下面的状态覆盖
+		SetMovementMode(static_cast<EMovementMode>(Snapshot.MovementMode), Snapshot.CustomMovementMode);
 	}
-	return Super::GetMaxSpeed();
-}
 
-float UCustomMovementComponent::GetMaxAcceleration() const
-{
-	if (IsClimbing())
+	UpdatedComponent->SetWorldLocationAndRotation(Snapshot.Location, Snapshot.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	Velocity = Snapshot.Velocity;
+	Acceleration = Snapshot.Acceleration;
+
+	CurrentClimbableSurfaceLocation = Snapshot.SurfaceLocation;
+	CurrentClimbableSurfaceNormal = Snapshot.SurfaceNormal;
+	ClimbableSurfaceTraceHits.Reset(Snapshot.NumSurfaceHits);
+	for (int32 Index = 0; Index < Snapshot.NumSurfaceHits; Index++)
 	{
-		// 如果处于攀爬模式，返回攀爬加速度
-		return MaxClimbAcceleration;
+		FHitResult& Hit = ClimbableSurfaceTraceHits.AddDefaulted_GetRef();
+		Hit.bBlockingHit = true;
+		Hit.Location = Snapshot.SurfaceHitPoints[Index];
+		Hit.ImpactPoint = Snapshot.SurfaceHitPoints[Index];
+		Hit.Normal = Snapshot.SurfaceHitNormals[Index];
+		Hit.ImpactNormal = Snapshot.SurfaceHitNormals[Index];
+		Hit.Component = Snapshot.SurfaceHitComponents[Index];
 	}
-	return Super::GetMaxAcceleration();
+	CurrentClimbSurface = Snapshot.SurfaceProperties;
+	ClimbGripTime = Snapshot.GripTime;
+
+	CornerTransition = Snapshot.CornerTransition;
+	LedgeSegment = Snapshot.LedgeSegment;
+	LedgeHangDistance = Snapshot.LedgeHangDistance;
+	ActiveClimbPath = Snapshot.ClimbPath.Get();	// 路径已经被销毁时为空，PhysClimbPath 会结束路径攀爬
+	ClimbPathDistance = Snapshot.ClimbPathDistance;
+	ClimbPathSpeed = Snapshot.ClimbPathSpeed;
+	WallJumpTarget = Snapshot.WallJumpTarget;
+
+	if (CharacterAnimInstance)
+	{
+		if (UAnimMontage* SnapshotMontage = Snapshot.Montage.Get())
+		{
+			if (CharacterAnimInstance->GetCurrentActiveMontage() != SnapshotMontage)
+			{
+				CharacterAnimInstance->Montage_Play(SnapshotMontage, Snapshot.MontagePlayRate);
+			}
+			CharacterAnimInstance->Montage_SetPosition(SnapshotMontage, Snapshot.MontagePosition);
+		}
+		else if (CharacterAnimInstance->GetCurrentActiveMontage())
+		{
+			CharacterAnimInstance->Montage_Stop(0.f);
+		}
+	}
+	OpenClimbWindows = Snapshot.OpenClimbWindows;
+
+	if (ClimbingSystemCharacter && ClimbingSystemCharacter->GetMotionWarpingComponent())
+	{
+		for (int32 Index = 0; Index < Snapshot.NumWarpTargets; Index++)
+		{
+			ClimbingSystemCharacter->GetMotionWarpingComponent()->AddOrUpdateWarpTargetFromLocationAndRotation(
+				Snapshot.WarpTargetNames[Index], Snapshot.WarpTargetLocations[Index], Snapshot.WarpTargetRotations[Index].Rotator());
+		}
+	}
+
+	// 基座缓存和顶端预测都对应旧的状态，下一帧重新检测
+	InvalidateClimbSurfaceBase();
+	TopOutPrediction = FClimbTopOutPrediction();
 }
 
-FVector UCustomMovementComponent::ConstrainAnimRootMotionVelocity(const FVector& RootMotionVelocity, const FVector& CurrentVelocity) const
+int32 UCustomMovementComponent::ResimulateClimb(const FClimbSnapshot& CorrectedSnapshot, int32 NumFrames)
 {
-	// 这里之所以重写这个函数，是因为我们需要在攀爬模式下，限制根动作的速度，使角色在攀爬时不会因为根动作速度过大而脱离攀爬表面
-	// 同时，在父类中，这个函数会判断角色是否处于掉落状态，如果是，会将根动作速度限制为0，这样会导致角色在攀爬时无法播放根动作
-	if (IsFalling() && CharacterAnimInstance && CharacterAnimInstance->IsAnyMontagePlaying())
+	// 先取出需要重放的输入，之后这些帧的快照会被重新写入
+	TArray<TPair<FVector, float>, TInlineAllocator<64>> ReplayInputs;
+	for (int32 Index = 1; Index <= NumFrames; Index++)
 	{
-		// 如果角色处于掉落状态，并且有动画蒙太奇正在播放
-		return RootMotionVelocity;
+		const FClimbSnapshot* Recorded = ClimbSnapshots.Find(CorrectedSnapshot.Frame + Index);
+		if (!Recorded)
+		{
+			break;
+		}
+		ReplayInputs.Emplace(Recorded->Acceleration, Recorded->DeltaTime);
 	}
-	else
+
+	TGuardValue<bool> ResimulateGuard(bResimulatingClimb, true);
+
+	RestoreClimbSnapshot(CorrectedSnapshot);
+	ClimbSnapshots.DiscardAfter(CorrectedSnapshot.Frame);
+	if (FClimbSnapshot* Slot = ClimbSnapshots.Find(CorrectedSnapshot.Frame))
 	{
-		return Super::ConstrainAnimRootMotionVelocity(RootMotionVelocity, CurrentVelocity);
+		*Slot = CorrectedSnapshot;
+	}
+
+	for (int32 Index = 0; Index < ReplayInputs.Num(); Index++)
+	{
+		const float DeltaTime = ReplayInputs[Index].Value;
+		Acceleration = ReplayInputs[Index].Key;
+
+		// 和正常的一帧一样走完整的移动流程（包括根动作）
+		PerformMovement(DeltaTime);
+
+		FClimbSnapshot& Snapshot = ClimbSnapshots.Push();
+		SaveClimbSnapshot(Snapshot);
+		Snapshot.Frame = CorrectedSnapshot.Frame + Index + 1;
+		Snapshot.DeltaTime = DeltaTime;
+		Snapshot.Acceleration = ReplayInputs[Index].Key;
 	}
+
+	ClimbSimFrame = CorrectedSnapshot.Frame + ReplayInputs.Num();
+	return ReplayInputs.Num();
 }
 
-bool UCustomMovementComponent::TraceClimbableSurface()
+int32 UCustomMovementComponent::ResimulateClimbFromFrame(uint32 Frame)
 {
+	const FClimbSnapshot* Snapshot = ClimbSnapshots.Find(Frame);
+	if (!Snapshot || Frame >= ClimbSimFrame)
+	{
+		return 0;
+	}
 
-	const FVector StartOffset = UpdatedComponent->GetForwardVector() * 30.0f;
-	const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
-	const FVector End = Start + UpdatedComponent->GetForwardVector();
+	// 先拷贝，重新模拟会覆盖缓冲区
+	const FClimbSnapshot StartSnapshot = *Snapshot;
+	return ResimulateClimb(StartSnapshot, ClimbSimFrame - Frame);
+}
 
-	ClimbableSurfaceTraceHits = DoCapsuleTraceMultiByObject(Start, End, false);
+bool UCustomMovementComponent::ShouldValidateClimbMoves() const
+{
+	return bValidateClimbMoves && CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy;
+}
 
-	return !ClimbableSurfaceTraceHits.IsEmpty();
+bool UCustomMovementComponent::IsAwaitingClimbMoveClaims() const
+{
+	return bValidateClimbMoves && CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_Authority && CharacterOwner->GetRemoteRole() == ROLE_AutonomousProxy;
 }
 
-FHitResult UCustomMovementComponent::TraceFromEyeHeight(float TraceDistance, float TraceStartOffset, bool bShowDebug, bool bDrawPersistantShapes) const
+FClimbMoveClaim UCustomMovementComponent::MakeStartClimbClaim() const
 {
-	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-	const FVector EyeHeightOffset = UpdatedComponent->GetUpVector() * (CharacterOwner->BaseEyeHeight + TraceStartOffset);
+	FClimbMoveClaim Claim;
+	Claim.MoveType = EClimbMoveType::StartClimb;
 
-	const FVector Start = ComponentLocation + EyeHeightOffset;
-	const FVector End = Start + UpdatedComponent->GetForwardVector() * TraceDistance;
+	if (!ClimbableSurfaceTraceHits.IsEmpty())
+	{
+		const FHitResult& SurfaceHit = ClimbableSurfaceTraceHits[0];
+		Claim.SurfaceComponent = SurfaceHit.GetComponent();
+		Claim.SurfacePoint = SurfaceHit.ImpactPoint;
+		Claim.SurfaceNormal = SurfaceHit.ImpactNormal;
+	}
 
-	return DoLineTraceSingleByObject(Start, End, bShowDebug, bDrawPersistantShapes);
+	return Claim;
 }
 
-FHitResult UCustomMovementComponent::TraceFromEyeHeight_V(float TraceDistance, float TraceStartOffset, bool bShowDebug, bool bDrawPersistantShapes) const
+void UCustomMovementComponent::SendClimbMoveClaim(const FClimbMoveClaim& Claim)
 {
-	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
-	const FVector EyeHeightOffset = UpdatedComponent->GetRightVector() * (CharacterOwner->BaseEyeHeight + TraceStartOffset);
+	if (ShouldValidateClimbMoves())
+	{
+		Server_RequestClimbMove(Claim);
+	}
+}
 
-	const FVector Start = ComponentLocation + EyeHeightOffset;
-	const FVector End = Start + UpdatedComponent->GetForwardVector() * TraceDistance;
+void UCustomMovementComponent::Server_RequestClimbMove_Implementation(const FClimbMoveClaim& Claim)
+{
+	if (!ValidateClimbMove(Claim))
+	{
+		// 拒绝后服务器不执行动作，客户端会被移动修正拉回
+		// 客户端可能每帧都发送无效的声明，日志每秒最多一条，其余只计入统计
+		const double Now = GetWorld()->GetRealTimeSeconds();
+		if (Now - LastClimbMoveRejectLogTime >= 1.0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: rejected climb move %s at %s (%d more rejections suppressed)"),
+				*GetNameSafe(CharacterOwner), *UEnum::GetValueAsString(Claim.MoveType), *Claim.SurfacePoint.ToString(), NumSuppressedClimbMoveRejectLogs);
+			LastClimbMoveRejectLogTime = Now;
+			NumSuppressedClimbMoveRejectLogs = 0;
+		}
+		else
+		{
+			NumSuppressedClimbMoveRejectLogs++;
+		}
+		RecordClimbTelemetry(EClimbTelemetryEvent::MoveRejected);
+		return;
+	}
 
-	return DoLineTraceSingleByObject(Start, End, bShowDebug, bDrawPersistantShapes);
+	ExecuteClimbMove(Claim);
 }
 
-TArray<FHitResult> UCustomMovementComponent::DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, bool bShowDebug, bool bDrawPersistantShapes) const
+bool UCustomMovementComponent::ValidateClimbMove(const FClimbMoveClaim& Claim)
 {
-	TArray<FHitResult> HitResults;
+	CLIMB_VLOG_PROBE_SCOPE("ValidateMove");
+
+	// 不需要检测的状态和距离校验
+	const FVector ComponentLocation = UpdatedComponent->GetComponentLocation();
+	if (FVector::DistSquared(ComponentLocation, Claim.SurfacePoint) > FMath::Square(ClimbValidationReach))
+	{
+		INC_DWORD_STAT(STAT_ClimbValidationRejected);
+		return false;
+	}
+
+	switch (Claim.MoveType)
+	{
+	case EClimbMoveType::StartClimb:
+		if (IsFalling() || IsClimbing() || IsOnClimbPath() || IsLedgeHanging() || !IsClimbableSurfaceNormal(Claim.SurfaceNormal))
+		{
+			INC_DWORD_STAT(STAT_ClimbValidationRejected);
+			return false;
+		}
+		if (bUseClimbSurfaceMaterials && Claim.SurfaceComponent)
+		{
+			// 组件来自客户端，没有物理体的组件不可能被攀爬检测命中
+			const FBodyInstance* SurfaceBody = Claim.SurfaceComponent->GetBodyInstance();
+			if (!SurfaceBody || !ClimbSurfaceMaterials.Resolve(SurfaceBody->GetSimplePhysicalMaterial()).bClimbable)
+			{
+				INC_DWORD_STAT(STAT_ClimbValidationRejected);
+				return false;
+			}
+		}
+		break;
+	case EClimbMoveType::Dash:
+		if (!IsClimbing() || !CurrentClimbSurface.bAllowDash || !ClimbDashDirections.IsValidIndex(Claim.DashDirectionIndex))
+		{
+			INC_DWORD_STAT(STAT_ClimbValidationRejected);
+			return false;
+		}
+		break;
+	case EClimbMoveType::Vault:
+		if (IsFalling() || IsClimbing() || FVector::DistSquared(ComponentLocation, Claim.TargetPoint) > FMath::Square(ClimbValidationReach))
+		{
+			INC_DWORD_STAT(STAT_ClimbValidationRejected);
+			return false;
+		}
+		break;
+	}
+
+	UClimbValidationSubsystem* ValidationSubsystem = GetWorld()->GetSubsystem<UClimbValidationSubsystem>();
+	if (!ValidationSubsystem)
+	{
+		FHitResult SurfaceHit;
+		FHitResult TargetHit;
+		return ValidateClimbMoveWithTraces(Claim, SurfaceHit, TargetHit);
+	}
+
+	FClimbGeometryCache& GeometryCache = ValidationSubsystem->GetGeometryCache();
+	FClimbValidationStats& Stats = GeometryCache.GetStats();
+
+	// 声明的每个点都先查缓存，任何一个点明显不在组件上就直接拒绝
+	EClimbGeometryCheck Check = GeometryCache.CheckSurfacePoint(Claim.SurfaceComponent, Claim.SurfacePoint, Claim.SurfaceNormal, ClimbValidationTolerance, ClimbValidationNormalDot);
+	if (Claim.MoveType == EClimbMoveType::Vault && Check != EClimbGeometryCheck::Rejected)
+	{
+		const EClimbGeometryCheck TargetCheck = GeometryCache.CheckSurfacePoint(Claim.TargetComponent, Claim.TargetPoint, Claim.TargetNormal, ClimbValidationTolerance, ClimbValidationNormalDot);
+		if (TargetCheck != EClimbGeometryCheck::Accepted)
+		{
+			Check = TargetCheck;
+		}
+	}
 
-	const EDrawDebugTrace::Type DebugTraceType = bDrawPersistantShapes ? EDrawDebugTrace::Persistent : EDrawDebugTrace::ForDuration;
+	if (Check == EClimbGeometryCheck::Rejected)
+	{
+		Stats.CheapRejected++;
+		INC_DWORD_STAT(STAT_ClimbValidationRejected);
+		return false;
+	}
+
+	if (Check == EClimbGeometryCheck::Accepted)
+	{
+		// 缓存只能证明声明点在组件表面上，动作本身（冲刺距离和轨迹、顶端和头顶空间）仍需检测
+		if (!ValidateClimbMoveTarget(Claim))
+		{
+			Stats.Rejected++;
+			INC_DWORD_STAT(STAT_ClimbValidationRejected);
+			return false;
+		}
+
+		Stats.CheapAccepted++;
+		INC_DWORD_STAT(STAT_ClimbValidationCheapAccepted);
+		return true;
+	}
 
-	UKismetSystemLibrary::CapsuleTraceMultiForObjects(
-		this,
-		Start,
-		End,
-		ClimbCapsuleTraceRadius,
-		ClimbCapsuleTraceHalfHeight,
-		ClimbTraceObjectTypes,
-		false,
-		TArray<AActor*>(),
-		bShowDebug ? DebugTraceType : EDrawDebugTrace::None,
-		HitResults,
-		false
-	);
+	// 缓存无法判断，回退到完整检测，通过后写入缓存
+	Stats.FullTraceValidations++;
+	INC_DWORD_STAT(STAT_ClimbValidationFullTraces);
+
+	FHitResult SurfaceHit;
+	FHitResult TargetHit;
+	if (!ValidateClimbMoveWithTraces(Claim, SurfaceHit, TargetHit))
+	{
+		Stats.Rejected++;
+		INC_DWORD_STAT(STAT_ClimbValidationRejected);
+		return false;
+	}
 
+	GeometryCache.AddSurfaceSample(SurfaceHit.GetComponent(), SurfaceHit.ImpactPoint, SurfaceHit.ImpactNormal);
+	if (TargetHit.bBlockingHit)
+	{
+		GeometryCache.AddSurfaceSample(TargetHit.GetComponent(), TargetHit.ImpactPoint, TargetHit.ImpactNormal);
+	}
 
-	return HitResults;
+	return true;
+}
 
+bool UCustomMovementComponent::TraceClaimedSurfacePoint(const UPrimitiveComponent* Component, const FVector& Point, const FVector& Normal, FHitResult& OutHit) const
+{
+	// 沿声明的法线穿过声明点检测，命中点和法线都要在容差内
+	const FVector Offset = Normal.GetSafeNormal() * (ClimbValidationTolerance + 1.f);
+	OutHit = DoLineTraceSingleByObject(Point + Offset, Point - Offset);
+
+	return OutHit.bBlockingHit
+		&& (!Component || OutHit.GetComponent() == Component)
+		&& FVector::DistSquared(OutHit.ImpactPoint, Point) <= FMath::Square(ClimbValidationTolerance)
+		&& FVector::DotProduct(OutHit.ImpactNormal, Normal) >= ClimbValidationNormalDot;
 }
 
-FHitResult UCustomMovementComponent::DoLineTraceSingleByObject(const FVector& Start, const FVector& End, bool bShowDebug, bool bDrawPersistantShapes) const
+bool UCustomMovementComponent::ValidateClimbMoveWithTraces(const FClimbMoveClaim& Claim, FHitResult& OutSurfaceHit, FHitResult& OutTargetHit)
 {
-	FHitResult HitResult;
+	if (!TraceClaimedSurfacePoint(Claim.SurfaceComponent, Claim.SurfacePoint, Claim.SurfaceNormal, OutSurfaceHit))
+	{
+		return false;
+	}
+
+	if (Claim.MoveType == EClimbMoveType::Vault && !TraceClaimedSurfacePoint(Claim.TargetComponent, Claim.TargetPoint, Claim.TargetNormal, OutTargetHit))
+	{
+		return false;
+	}
+
+	return ValidateClimbMoveTarget(Claim);
+}
 
-	const EDrawDebugTrace::Type DebugTraceType = bDrawPersistantShapes ? EDrawDebugTrace::Persistent : EDrawDebugTrace::ForDuration;
+bool UCustomMovementComponent::ValidateClimbMoveTarget(const FClimbMoveClaim& Claim) const
+{
+	switch (Claim.MoveType)
+	{
+	case EClimbMoveType::StartClimb:
+		// 和 CanStartClimbing 一样需要检测到攀爬顶端
+		return TraceFromEyeHeight(100.f).bBlockingHit;
+	case EClimbMoveType::Dash:
+		{
+			// 目标点必须在所选方向的检测线段上（和 QueryClimbDashCandidates 相同），不能是触及范围内的任意点
+			const FClimbDashDirection& DashDirection = ClimbDashDirections[Claim.DashDirectionIndex];
+			const FVector ComponentUp = UpdatedComponent->GetUpVector();
+			const FVector WorldDirection = (UpdatedComponent->GetRightVector() * DashDirection.Direction.X + ComponentUp * DashDirection.Direction.Y).GetSafeNormal();
+			const FVector ProbeStart = UpdatedComponent->GetComponentLocation() + ComponentUp * CharacterOwner->BaseEyeHeight + WorldDirection * DashDirection.ProbeDistance;
+			const FVector ProbeEnd = ProbeStart + UpdatedComponent->GetForwardVector() * DashDirection.ForwardTraceDistance;
+			if (FMath::PointDistToSegmentSquared(Claim.SurfacePoint, ProbeStart, ProbeEnd) > FMath::Square(ClimbValidationTolerance))
+			{
+				return false;
+			}
 
-	UKismetSystemLibrary::LineTraceSingleForObjects(
-		this,
-		Start,
-		End,
-		ClimbTraceObjectTypes,
-		false,
-		TArray<AActor*>(),
-		bShowDebug ? DebugTraceType : EDrawDebugTrace::None,
-		HitResult,
-		false
-	);
+			return ValidateClimbDashTrajectory(DashDirection, Claim.SurfacePoint);
+		}
+	case EClimbMoveType::Vault:
+		// 翻越点已经单独校验，这里只检测头顶空间
+		return !TraceFromEyeHeight(100.f).bBlockingHit;
+	}
 
-	return HitResult;
+	return false;
 }
 
+void UCustomMovementComponent::ExecuteClimbMove(const FClimbMoveClaim& Claim)
+{
+	switch (Claim.MoveType)
+	{
+	case EClimbMoveType::StartClimb:
+		PlayClimbMontage(AnimMontage_StandToWallUp);
+		break;
+	case EClimbMoveType::Dash:
+		{
+			const FClimbDashDirection& DashDirection = ClimbDashDirections[Claim.DashDirectionIndex];
+			SetMotionWarpingTarget(DashDirection.WarpTargetName, Claim.SurfacePoint);
+			PlayClimbMontage(DashDirection.Montage);
+		}
+		break;
+	case EClimbMoveType::Vault:
+		SetMotionWarpingTarget("VaultStartPoint", Claim.SurfacePoint);
+		SetMotionWarpingTarget("VaultEndPoint", Claim.TargetPoint);
+		StartClimbing();
+		PlayClimbMontage(AnimMontage_Vaulting);
+		break;
+	}
+}
 
+void UCustomMovementComponent::RecordClimbTelemetry(EClimbTelemetryEvent Event) const
+{
+	if (CS_ClimbTelemetry::IsEnabled())
+	{
+		CS_ClimbTelemetry::Record(GetWorld(), Event, UpdatedComponent->GetComponentLocation());
+	}
+}
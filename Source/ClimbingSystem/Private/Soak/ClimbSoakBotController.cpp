@@ -0,0 +1,152 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "Soak/ClimbSoakBotController.h"
+
+#include "ClimbingSystem/ClimbingSystemCharacter.h"
+#include "CustomComponents/CustomMovementComponent.h"
+
+AClimbSoakBotController::AClimbSoakBotController()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+}
+
+void AClimbSoakBotController::InitializeBot(int32 Seed)
+{
+	RandomStream.Initialize(Seed);
+	PickWanderDirection();
+}
+
+void AClimbSoakBotController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	// 机器人输入在角色移动之前生成
+	if (InPawn)
+	{
+		InPawn->AddTickPrerequisiteActor(this);
+	}
+}
+
+void AClimbSoakBotController::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	AClimbingSystemCharacter* Character = Cast<AClimbingSystemCharacter>(GetPawn());
+	if (!Character || !Character->GetCustomMovementComponent())
+	{
+		return;
+	}
+
+	const UCustomMovementComponent* Movement = Character->GetCustomMovementComponent();
+	if (Movement->IsLedgeHanging())
+	{
+		Action = EClimbSoakBotAction::Hang;
+	}
+	else if (Movement->IsClimbing() || Movement->IsOnClimbPath())
+	{
+		Action = EClimbSoakBotAction::Climb;
+	}
+	else
+	{
+		Action = EClimbSoakBotAction::Wander;
+	}
+
+	ActionTimeRemaining -= DeltaSeconds;
+
+	switch (Action)
+	{
+	case EClimbSoakBotAction::Wander:
+		TickWander(Character, DeltaSeconds);
+		break;
+	case EClimbSoakBotAction::Climb:
+		TickClimb(Character, DeltaSeconds);
+		break;
+	case EClimbSoakBotAction::Hang:
+		TickHang(Character, DeltaSeconds);
+		break;
+	}
+}
+
+void AClimbSoakBotController::PickWanderDirection()
+{
+	const float Yaw = RandomStream.FRandRange(0.f, 360.f);
+	WanderDirection = FRotator(0.f, Yaw, 0.f).Vector();
+	ActionTimeRemaining = RandomStream.FRandRange(2.f, 6.f);
+	StuckTime = 0.f;
+}
+
+void AClimbSoakBotController::TickWander(AClimbingSystemCharacter* Character, float DeltaSeconds)
+{
+	UCustomMovementComponent* Movement = Character->GetCustomMovementComponent();
+
+	if (ActionTimeRemaining <= 0.f)
+	{
+		PickWanderDirection();
+	}
+
+	// 走不动时多半是撞到了墙，换方向前先尝试上墙
+	StuckTime = Movement->Velocity.Size2D() < 10.f ? StuckTime + DeltaSeconds : 0.f;
+	if (StuckTime > 1.5f)
+	{
+		PickWanderDirection();
+	}
+
+	Character->AddMovementInput(WanderDirection, 1.f);
+
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	if (WorldTime >= NextClimbAttemptTime && !Movement->IsFalling())
+	{
+		// 和玩家按下攀爬键一样：路径、上墙、下爬、翻越依次尝试
+		Movement->ToggleClimbingMode(true);
+		NextClimbAttemptTime = WorldTime + ClimbAttemptInterval * RandomStream.FRandRange(0.5f, 1.5f);
+		NumActions++;
+	}
+}
+
+void AClimbSoakBotController::TickClimb(AClimbingSystemCharacter* Character, float DeltaSeconds)
+{
+	UCustomMovementComponent* Movement = Character->GetCustomMovementComponent();
+
+	if (ActionTimeRemaining <= 0.f)
+	{
+		// 大部分时间向上爬，偶尔横移或者向下
+		const float Roll = RandomStream.FRand();
+		ClimbInput = Roll < 0.6f ? FVector2D(RandomStream.FRandRange(-0.3f, 0.3f), 1.f)
+			: Roll < 0.9f ? FVector2D(RandomStream.FRandBool() ? 1.f : -1.f, 0.f)
+			: FVector2D(0.f, -1.f);
+		ActionTimeRemaining = RandomStream.FRandRange(0.5f, 2.5f);
+	}
+
+	// 和 HandleClimbingMovementInput 一样把输入映射到攀爬平面
+	const FVector SurfaceNormal = Movement->GetCurrentClimbableSurfaceNormal();
+	const FVector UpDirection = FVector::CrossProduct(-SurfaceNormal, Character->GetActorRightVector()).GetSafeNormal();
+	const FVector RightDirection = FVector::CrossProduct(-SurfaceNormal, -Character->GetActorUpVector()).GetSafeNormal();
+	Character->AddMovementInput(UpDirection, ClimbInput.Y);
+	Character->AddMovementInput(RightDirection, ClimbInput.X);
+
+	if (RandomStream.FRand() < DashChancePerSecond * DeltaSeconds)
+	{
+		Movement->ClimbDash();
+		NumActions++;
+	}
+	else if (RandomStream.FRand() < WallJumpChancePerSecond * DeltaSeconds)
+	{
+		Movement->WallJump();
+		NumActions++;
+	}
+}
+
+void AClimbSoakBotController::TickHang(AClimbingSystemCharacter* Character, float DeltaSeconds)
+{
+	if (ActionTimeRemaining <= 0.f)
+	{
+		// 横移一段时间后爬上去
+		ClimbInput = RandomStream.FRand() < 0.5f ? FVector2D(RandomStream.FRandBool() ? 1.f : -1.f, 0.f) : FVector2D(0.f, 1.f);
+		ActionTimeRemaining = RandomStream.FRandRange(0.5f, 2.f);
+	}
+
+	Character->AddMovementInput(FVector::UpVector, ClimbInput.Y);
+	Character->AddMovementInput(Character->GetActorRightVector(), ClimbInput.X);
+}
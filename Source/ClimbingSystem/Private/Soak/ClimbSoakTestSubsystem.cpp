@@ -0,0 +1,325 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+
+#include "Soak/ClimbSoakTestSubsystem.h"
+
+#include "Soak/ClimbSoakBotController.h"
+#include "Actors/ClimbStressLevelGenerator.h"
+#include "ClimbingSystem/ClimbingSystemCharacter.h"
+#include "CustomComponents/CustomMovementComponent.h"
+#include "CustomComponents/ClimbTelemetry.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/PlatformMemory.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "RenderCore.h"
+
+CSV_DEFINE_CATEGORY(ClimbSoak, true);
+
+namespace
+{
+	// 排序后的百分位
+	float GetPercentile(const TArray<float>& SortedValues, float Percentile)
+	{
+		if (SortedValues.IsEmpty())
+		{
+			return 0.f;
+		}
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+		return SortedValues[Index];
+	}
+
+	FString DescribePercentiles(const TCHAR* Label, TArray<float> Values)
+	{
+		Values.Sort();
+		double Sum = 0.0;
+		for (const float Value : Values)
+		{
+			Sum += Value;
+		}
+
+		return FString::Printf(TEXT("%-14s avg %7.2f  p50 %7.2f  p90 %7.2f  p95 %7.2f  p99 %7.2f  p99.9 %7.2f  max %7.2f ms"),
+			Label, Values.IsEmpty() ? 0.0 : Sum / Values.Num(),
+			GetPercentile(Values, 0.5f), GetPercentile(Values, 0.9f), GetPercentile(Values, 0.95f),
+			GetPercentile(Values, 0.99f), GetPercentile(Values, 0.999f), Values.IsEmpty() ? 0.f : Values.Last());
+	}
+}
+
+bool UClimbSoakTestSubsystem::ParseSettings(FClimbSoakSettings& OutSettings)
+{
+	const TCHAR* CommandLine = FCommandLine::Get();
+	if (!FParse::Param(CommandLine, TEXT("ClimbSoak")) && !FParse::Value(CommandLine, TEXT("ClimbSoak="), OutSettings.Duration))
+	{
+		return false;
+	}
+
+	FParse::Value(CommandLine, TEXT("ClimbSoak="), OutSettings.Duration);
+	FParse::Value(CommandLine, TEXT("ClimbSoakBots="), OutSettings.NumBots);
+	FParse::Value(CommandLine, TEXT("ClimbSoakSeed="), OutSettings.Seed);
+	FParse::Value(CommandLine, TEXT("ClimbSoakRadius="), OutSettings.SpawnRadius);
+	FParse::Value(CommandLine, TEXT("ClimbSoakHitchMs="), OutSettings.HitchMilliseconds);
+	FParse::Value(CommandLine, TEXT("ClimbSoakMaxGrowthMB="), OutSettings.MaxMemoryGrowthMB);
+	OutSettings.bExitWhenDone = !FParse::Param(CommandLine, TEXT("ClimbSoakNoExit"));
+
+	OutSettings.Duration = FMath::Max(OutSettings.Duration, 1.f);
+	OutSettings.NumBots = FMath::Max(OutSettings.NumBots, 1);
+	return true;
+}
+
+bool UClimbSoakTestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// 只有带 -ClimbSoak 启动的游戏世界才创建
+	FClimbSoakSettings UnusedSettings;
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && ParseSettings(UnusedSettings) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UClimbSoakTestSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (!ParseSettings(Settings) || InWorld.GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	// -ClimbStressSeed= 存在时生成压力测试关卡（AClimbStressLevelGenerator）
+	int32 StressSeed = 0;
+	if (FParse::Value(FCommandLine::Get(), TEXT("ClimbStressSeed="), StressSeed) && !UGameplayStatics::GetActorOfClass(&InWorld, AClimbStressLevelGenerator::StaticClass()))
+	{
+		// 地图里没有生成器时在原点生成一个，种子和规模由生成器自己从命令行读取
+		InWorld.SpawnActor<AClimbStressLevelGenerator>(FVector::ZeroVector, FRotator::ZeroRotator);
+	}
+
+	SpawnBots(InWorld);
+
+	FrameTimes.Reserve(FMath::CeilToInt(Settings.Duration * 120.f));
+	GameThreadTimes.Reserve(FrameTimes.Max());
+	RenderThreadTimes.Reserve(FrameTimes.Max());
+
+	StartTime = FPlatformTime::Seconds();
+	NextMemorySampleTime = StartTime;
+	StartUsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	PeakUsedMemory = StartUsedMemory;
+	bRunning = true;
+
+#if CSV_PROFILER
+	if (FCsvProfiler* CsvProfiler = FCsvProfiler::Get(); CsvProfiler && !CsvProfiler->IsCapturing())
+	{
+		CsvProfiler->BeginCapture(-1, FPaths::ProfilingDir() / TEXT("CSV"), FString::Printf(TEXT("ClimbSoak_%s.csv"), *FDateTime::Now().ToString()));
+	}
+	CSV_METADATA(TEXT("ClimbSoakBots"), *FString::FromInt(Settings.NumBots));
+	CSV_METADATA(TEXT("ClimbSoakSeed"), *FString::FromInt(Settings.Seed));
+#endif
+
+	UE_LOG(LogTemp, Display, TEXT("Climb soak started on %s: %d bots, seed %d, %.0f s"),
+		*InWorld.GetMapName(), Bots.Num(), Settings.Seed, Settings.Duration);
+}
+
+void UClimbSoakTestSubsystem::Deinitialize()
+{
+	if (bRunning)
+	{
+		// 地图被提前卸载时也输出已经收集到的数据
+		FinishSoak();
+	}
+
+	Super::Deinitialize();
+}
+
+TStatId UClimbSoakTestSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UClimbSoakTestSubsystem, STATGROUP_Tickables);
+}
+
+void UClimbSoakTestSubsystem::SpawnBots(UWorld& InWorld)
+{
+	const AGameModeBase* GameMode = InWorld.GetAuthGameMode();
+	UClass* PawnClass = GameMode ? GameMode->DefaultPawnClass.Get() : nullptr;
+	if (!PawnClass || !PawnClass->IsChildOf(AClimbingSystemCharacter::StaticClass()))
+	{
+		// 蓝图角色上配置了蒙太奇，原生类没有
+		UE_LOG(LogTemp, Warning, TEXT("Climb soak: default pawn is not a climbing character, spawning the native class"));
+		PawnClass = AClimbingSystemCharacter::StaticClass();
+	}
+
+	const AActor* PlayerStart = UGameplayStatics::GetActorOfClass(&InWorld, APlayerStart::StaticClass());
+	const FVector Center = PlayerStart ? PlayerStart->GetActorLocation() : FVector::ZeroVector;
+
+	FRandomStream RandomStream(Settings.Seed);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 Index = 0; Index < Settings.NumBots; Index++)
+	{
+		// 均匀分布在出生点周围的圆盘内
+		const float Angle = RandomStream.FRandRange(0.f, UE_TWO_PI);
+		const float Distance = Settings.SpawnRadius * FMath::Sqrt(RandomStream.FRand());
+		const FVector Location = Center + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * Distance;
+		const FRotator Rotation(0.f, RandomStream.FRandRange(0.f, 360.f), 0.f);
+
+		APawn* Pawn = InWorld.SpawnActor<APawn>(PawnClass, Location, Rotation, SpawnParameters);
+		AClimbSoakBotController* Bot = InWorld.SpawnActor<AClimbSoakBotController>(Location, Rotation);
+		if (!Pawn || !Bot)
+		{
+			continue;
+		}
+
+		Bot->InitializeBot(Settings.Seed * 7919 + Index);
+		Bot->Possess(Pawn);
+		Bots.Add(Bot);
+	}
+}
+
+void UClimbSoakTestSubsystem::Tick(float DeltaTime)
+{
+	SampleFrame();
+
+	if (FPlatformTime::Seconds() - StartTime >= Settings.Duration)
+	{
+		FinishSoak();
+	}
+}
+
+void UClimbSoakTestSubsystem::SampleFrame()
+{
+	const float FrameMilliseconds = FApp::GetDeltaTime() * 1000.f;
+	FrameTimes.Add(FrameMilliseconds);
+	GameThreadTimes.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+	RenderThreadTimes.Add(FPlatformTime::ToMilliseconds(GRenderThreadTime));
+
+	if (FrameMilliseconds > Settings.HitchMilliseconds && FrameTimes.Num() > 1)
+	{
+		// 第一帧包含加载，不算卡顿
+		NumHitches++;
+		WorstHitchMilliseconds = FMath::Max(WorstHitchMilliseconds, FrameMilliseconds);
+		CSV_EVENT(ClimbSoak, TEXT("Hitch %.1fms"), FrameMilliseconds);
+	}
+
+	uint32 FrameTraces = 0;
+	int32 NumClimbing = 0;
+	for (const AClimbSoakBotController* Bot : Bots)
+	{
+		const AClimbingSystemCharacter* Character = Bot ? Cast<AClimbingSystemCharacter>(Bot->GetPawn()) : nullptr;
+		const UCustomMovementComponent* Movement = Character ? Character->GetCustomMovementComponent() : nullptr;
+		if (!Movement)
+		{
+			continue;
+		}
+
+		FrameTraces += Movement->GetLastFrameClimbTraces();
+		if (Movement->IsClimbing() || Movement->IsOnClimbPath() || Movement->IsLedgeHanging())
+		{
+			NumClimbing++;
+		}
+	}
+
+	TotalTraces += FrameTraces;
+	PeakTracesPerFrame = FMath::Max(PeakTracesPerFrame, FrameTraces);
+	ClimbingBotFrames += NumClimbing;
+
+	CSV_CUSTOM_STAT(ClimbSoak, Traces, static_cast<int32>(FrameTraces), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ClimbSoak, ClimbingBots, NumClimbing, ECsvCustomStatOp::Set);
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now >= NextMemorySampleTime)
+	{
+		const uint64 UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+		PeakUsedMemory = FMath::Max(PeakUsedMemory, UsedMemory);
+		MemorySamples.Emplace(static_cast<float>(Now - StartTime), UsedMemory);
+		NextMemorySampleTime = Now + 1.0;
+	}
+}
+
+FString UClimbSoakTestSubsystem::BuildSummary() const
+{
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+	const double GrowthMB = (static_cast<double>(EndUsedMemory) - StartUsedMemory) / (1024.0 * 1024.0);
+
+	// 最后一半时间内的增长斜率，排除启动阶段的预热分配
+	double SlopeMBPerMinute = 0.0;
+	if (MemorySamples.Num() >= 4)
+	{
+		const TPair<float, uint64>& Mid = MemorySamples[MemorySamples.Num() / 2];
+		const TPair<float, uint64>& Last = MemorySamples.Last();
+		const float Span = Last.Key - Mid.Key;
+		if (Span > 0.f)
+		{
+			SlopeMBPerMinute = (static_cast<double>(Last.Value) - Mid.Value) / (1024.0 * 1024.0) / Span * 60.0;
+		}
+	}
+
+	double FrameSum = 0.0;
+	double GameThreadSum = 0.0;
+	for (int32 Index = 0; Index < FrameTimes.Num(); Index++)
+	{
+		FrameSum += FrameTimes[Index];
+		GameThreadSum += GameThreadTimes[Index];
+	}
+
+	TArray<FString> Lines;
+	Lines.Add(FString::Printf(TEXT("Climb soak: %d bots, seed %d, %.1f s, %d frames"), Bots.Num(), Settings.Seed, Elapsed, FrameTimes.Num()));
+	Lines.Add(DescribePercentiles(TEXT("Frame"), FrameTimes));
+	Lines.Add(DescribePercentiles(TEXT("Game thread"), GameThreadTimes));
+	Lines.Add(DescribePercentiles(TEXT("Render thread"), RenderThreadTimes));
+	Lines.Add(FString::Printf(TEXT("Game thread share of frame time %.1f%%, remaining %.1f%% waiting on render/worker threads or idle"),
+		FrameSum > 0.0 ? GameThreadSum / FrameSum * 100.0 : 0.0, FrameSum > 0.0 ? (1.0 - GameThreadSum / FrameSum) * 100.0 : 0.0));
+	Lines.Add(FString::Printf(TEXT("Hitches > %.0f ms: %d, worst %.1f ms"), Settings.HitchMilliseconds, NumHitches, WorstHitchMilliseconds));
+	Lines.Add(FString::Printf(TEXT("Traces: %llu total, %.1f per frame, peak %u per frame; climbing bot-frames %.1f%%"),
+		TotalTraces, FrameTimes.IsEmpty() ? 0.0 : static_cast<double>(TotalTraces) / FrameTimes.Num(), PeakTracesPerFrame,
+		FrameTimes.IsEmpty() || Bots.IsEmpty() ? 0.0 : static_cast<double>(ClimbingBotFrames) / (FrameTimes.Num() * Bots.Num()) * 100.0));
+
+	int32 NumActions = 0;
+	for (const AClimbSoakBotController* Bot : Bots)
+	{
+		NumActions += Bot ? Bot->GetNumActions() : 0;
+	}
+	Lines.Add(FString::Printf(TEXT("Bot actions: %d"), NumActions));
+	Lines.Add(FString::Printf(TEXT("Memory: start %.1f MB, end %.1f MB, peak %.1f MB, growth %.1f MB, late growth %.2f MB/min"),
+		StartUsedMemory / (1024.0 * 1024.0), EndUsedMemory / (1024.0 * 1024.0), PeakUsedMemory / (1024.0 * 1024.0), GrowthMB, SlopeMBPerMinute));
+
+	return FString::Join(Lines, LINE_TERMINATOR);
+}
+
+void UClimbSoakTestSubsystem::FinishSoak()
+{
+	bRunning = false;
+	EndUsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	PeakUsedMemory = FMath::Max(PeakUsedMemory, EndUsedMemory);
+
+	CS_ClimbTelemetry::Flush();
+
+#if CSV_PROFILER
+	if (FCsvProfiler* CsvProfiler = FCsvProfiler::Get(); CsvProfiler && CsvProfiler->IsCapturing())
+	{
+		CsvProfiler->EndCapture();
+	}
+#endif
+
+	const FString Summary = BuildSummary();
+	UE_LOG(LogTemp, Display, TEXT("%s"), *Summary);
+
+	const FString SummaryPath = FPaths::ProfilingDir() / TEXT("ClimbSoak") / FString::Printf(TEXT("ClimbSoak_%s.txt"), *FDateTime::Now().ToString());
+	FFileHelper::SaveStringToFile(Summary, *SummaryPath);
+
+	const double GrowthMB = (static_cast<double>(EndUsedMemory) - StartUsedMemory) / (1024.0 * 1024.0);
+	const bool bFailed = Settings.MaxMemoryGrowthMB > 0.f && GrowthMB > Settings.MaxMemoryGrowthMB;
+	if (bFailed)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Climb soak failed: memory grew %.1f MB (limit %.1f MB)"), GrowthMB, Settings.MaxMemoryGrowthMB);
+	}
+
+	if (Settings.bExitWhenDone)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bFailed ? 1 : 0);
+	}
+}
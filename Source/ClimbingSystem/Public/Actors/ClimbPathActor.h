@@ -0,0 +1,85 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ClimbPathActor.generated.h"
+
+class USplineComponent;
+class UBoxComponent;
+
+// 攀爬路径类型，每种类型对应一个自定义移动模式
+UENUM(BlueprintType)
+enum class EClimbPathType : uint8
+{
+	Ladder UMETA(DisplayName = "Ladder"),		// 梯子
+	Rope UMETA(DisplayName = "Rope"),			// 绳索
+	Pipe UMETA(DisplayName = "Pipe"),			// 水管
+	Zipline UMETA(DisplayName = "Zipline"),		// 滑索
+};
+
+/**
+ * 由样条线定义的攀爬路径（梯子、绳索、水管、滑索）
+ * 角色在路径上时只沿样条线移动，除了进入和离开时的校验外不做任何物理检测
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API AClimbPathActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AClimbPathActor();
+
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	float GetPathLength() const;	// 获取路径长度
+
+	float FindDistanceClosestToWorldLocation(const FVector& WorldLocation) const;	// 获取离世界坐标最近的路径距离
+
+	// 获取路径上某一距离处角色的附着位置、旋转和“表面”法线（用于攀爬输入的方向计算）
+	void GetAttachTransformAtDistance(float Distance, FVector& OutLocation, FQuat& OutRotation, FVector& OutSurfaceNormal) const;
+
+	FVector GetDirectionAtDistance(float Distance) const;	// 获取路径上某一距离处的切线方向
+
+	bool GetExitLocation(bool bAtEnd, FVector& OutExitLocation) const;	// 获取路径两端的离开位置，没有配置则返回false
+
+	FORCEINLINE USplineComponent* GetClimbSpline() const { return ClimbSpline; }
+	FORCEINLINE EClimbPathType GetPathType() const { return PathType; }
+	FORCEINLINE float GetMaxPathSpeed() const { return MaxPathSpeed; }
+	FORCEINLINE float GetEntryDistance() const { return EntryDistance; }
+
+private:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true"))
+	USplineComponent* ClimbSpline;		// 攀爬路径样条线
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true"))
+	UBoxComponent* EntryVolume;			// 进入检测体积，根据样条线自动调整大小，角色只需要查询已有的重叠结果
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true"))
+	EClimbPathType PathType = EClimbPathType::Ladder;	// 路径类型
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true"))
+	float MaxPathSpeed = 150.f;		// 沿路径移动的最大速度
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true"))
+	float AttachDistance = 40.f;	// 角色中心离样条线的距离（沿Actor前向）
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true", EditCondition = "PathType == EClimbPathType::Zipline"))
+	float ZiplineHangOffset = 100.f;	// 滑索时角色中心在样条线下方的距离
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true"))
+	float EntryDistance = 100.f;	// 允许抓住路径的最大距离
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true"))
+	bool bExitAtStart = false;		// 到达起点时是否离开到StartExitOffset
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true", EditCondition = "bExitAtStart", MakeEditWidget))
+	FVector StartExitOffset = FVector::ZeroVector;	// 起点离开位置（Actor本地坐标）
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true"))
+	bool bExitAtEnd = true;		// 到达终点时是否离开到EndExitOffset（例如梯子顶端）
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ClimbPath, meta = (AllowPrivateAccess = "true", EditCondition = "bExitAtEnd", MakeEditWidget))
+	FVector EndExitOffset = FVector::ZeroVector;	// 终点离开位置（Actor本地坐标）
+};
@@ -0,0 +1,112 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ClimbStressLevelGenerator.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UProceduralMeshComponent;
+class UStaticMesh;
+class UMaterialInterface;
+
+/**
+ * 种子化的攀爬压力测试关卡生成器
+ * 生成密集墙面网格、边缘阶梯、翻越方块场、内外拐角、悬垂墙和高面数岩石，用于基准测试和浸泡测试
+ * 每个区域使用独立的随机流，同样的种子和参数总是生成同样的世界；修改一个区域的数量不会影响其他区域
+ * 可以放在关卡里随 BeginPlay 生成，也可以在编辑器中点击 Generate；-ClimbStressSeed= 和 -ClimbStressScale= 覆盖参数
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API AClimbStressLevelGenerator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AClimbStressLevelGenerator();
+
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Climb Stress")
+	void Generate();	// 清除后按当前种子重新生成
+
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Climb Stress")
+	void Clear();
+
+	// 生成结果的摘要（实例数、三角形数），便于在不同构建之间确认生成的是同一个世界
+	FString DescribeGeneratedWorld() const;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	// 每个区域的原点，沿 X 方向依次排开
+	FVector GetSectionOrigin(int32 SectionIndex) const;
+
+	void GenerateWallGrid(FRandomStream& RandomStream, const FVector& Origin);
+	void GenerateLedgeLadders(FRandomStream& RandomStream, const FVector& Origin);
+	void GenerateVaultBlocks(FRandomStream& RandomStream, const FVector& Origin);
+	void GenerateCorners(FRandomStream& RandomStream, const FVector& Origin);
+	void GenerateOverhangs(FRandomStream& RandomStream, const FVector& Origin);
+	void GenerateRocks(FRandomStream& RandomStream, const FVector& Origin);
+
+	// 添加一个方块实例：Center 为底面中心，Size 为厘米尺寸
+	void AddBlock(const FVector& BottomCenter, const FRotator& Rotation, const FVector& Size);
+
+	// 带噪声位移的细分二十面体
+	void BuildRockMesh(FRandomStream& RandomStream, int32 SectionIndex, const FVector& Center, float Radius);
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Stress")
+	USceneComponent* SceneRoot;
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Stress")
+	UInstancedStaticMeshComponent* BlockInstances;		// 所有墙、边缘、方块共享一个实例组件
+
+	UPROPERTY(VisibleAnywhere, Category = "Climb Stress")
+	UProceduralMeshComponent* RockMesh;					// 所有岩石，每块一个网格段，使用复杂碰撞
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress")
+	UStaticMesh* BlockMesh;			// 100 厘米立方体
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress")
+	UMaterialInterface* RockMaterial;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress")
+	int32 Seed = 1;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress", meta = (ClampMin = "1"))
+	int32 Scale = 1;				// 所有区域的数量倍数
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress")
+	bool bGenerateOnBeginPlay = true;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress", meta = (ClampMin = "100.0"))
+	float SectionSpacing = 6000.f;	// 区域之间的距离
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress|Walls", meta = (ClampMin = "0"))
+	int32 WallGridSize = 12;		// 墙面网格的边长（格子数）
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress|Walls", meta = (ClampMin = "100.0"))
+	float WallGridSpacing = 350.f;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress|Ledges", meta = (ClampMin = "0"))
+	int32 LedgeLadderCount = 8;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress|Ledges", meta = (ClampMin = "1"))
+	int32 LedgesPerLadder = 10;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress|Vault", meta = (ClampMin = "0"))
+	int32 VaultBlockCount = 200;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress|Corners", meta = (ClampMin = "0"))
+	int32 CornerCount = 24;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress|Overhangs", meta = (ClampMin = "0"))
+	int32 OverhangCount = 12;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress|Rocks", meta = (ClampMin = "0"))
+	int32 RockCount = 6;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Stress|Rocks", meta = (ClampMin = "0", ClampMax = "7"))
+	int32 RockSubdivisions = 5;		// 每级细分三角形数乘以4，5级为20480个三角形
+
+	int32 NumRockTriangles = 0;
+};
@@ -0,0 +1,36 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "AnimNotifyState_ClimbWindow.generated.h"
+
+// 攀爬蒙太奇中的窗口类型
+UENUM(BlueprintType)
+enum class EClimbWindowType : uint8
+{
+	MovementModeSwitch UMETA(DisplayName = "Movement Mode Switch"),	// 开始时切换移动模式（不再等蒙太奇淡出）
+	InputAccept UMETA(DisplayName = "Input Accept"),				// 窗口内的输入会被缓存
+	Cancel UMETA(DisplayName = "Cancel"),							// 窗口内可以被新的动作打断
+};
+
+/**
+ * 在攀爬蒙太奇中标记移动模式切换、输入缓存和打断的时间窗口
+ */
+UCLASS(meta = (DisplayName = "Climb Window"))
+class CLIMBINGSYSTEM_API UAnimNotifyState_ClimbWindow : public UAnimNotifyState
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference) override;
+
+	virtual void NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+
+	virtual FString GetNotifyName_Implementation() const override;
+
+private:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Window", meta = (AllowPrivateAccess = "true"))
+	EClimbWindowType WindowType = EClimbWindowType::MovementModeSwitch;
+};
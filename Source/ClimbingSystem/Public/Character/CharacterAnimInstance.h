@@ -4,11 +4,64 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "WorldCollision.h"
 #include "CharacterAnimInstance.generated.h"
 
 class AClimbingSystemCharacter;
 class UCustomMovementComponent;
 
+// 攀爬时做 IK 的四肢
+UENUM()
+enum class EClimbLimb : uint8
+{
+	HandLeft,
+	HandRight,
+	FootLeft,
+	FootRight,
+
+	MAX UMETA(Hidden)
+};
+
+// 单个肢体的 IK 目标（世界空间），在动画蓝图中用于双骨骼 IK
+USTRUCT(BlueprintType)
+struct FClimbLimbIKTarget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climb IK")
+	FVector Location = FVector::ZeroVector;		// 目标位置
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climb IK")
+	FVector Normal = FVector::ZeroVector;		// 目标处的表面法线
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climb IK")
+	float Alpha = 0.f;							// IK 权重
+};
+
+// 游戏线程在 NativeUpdateAnimation 中拷贝的攀爬表面，工作线程只读取这份数据
+struct FClimbLimbIKInputs
+{
+	static constexpr int32 MaxSurfaceSamples = 8;
+
+	bool bActive = false;			// 攀爬中且没有播放蒙太奇
+	FTransform ActorTransform;
+	FVector SurfaceLocation = FVector::ZeroVector;
+	FVector SurfaceNormal = FVector::ZeroVector;
+
+	int32 NumSurfaceSamples = 0;	// 移动组件这一帧的表面命中
+	FVector SurfacePoints[MaxSurfaceSamples];
+	FVector SurfaceNormals[MaxSurfaceSamples];
+};
+
+// 单个肢体的细化检测结果，记录为相对拟合平面的深度，表面移动时仍然有效
+struct FClimbLimbRefinement
+{
+	bool bValid = false;
+	float Depth = 0.f;				// 命中点在拟合平面法线方向上的偏移
+	FVector Normal = FVector::ZeroVector;
+	float Time = 0.f;				// 结果返回的时间
+};
+
 /**
  * 
  */
@@ -22,6 +75,8 @@ public:
 
 	virtual void NativeUpdateAnimation(float DeltaSeconds) override;	// 在动画实例更新时调用，相当于游戏中的Tick
 
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;	// 在动画工作线程上调用，只能读取 NativeUpdateAnimation 拷贝的数据
+
 
 private:
 	UPROPERTY()
@@ -53,5 +108,77 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Reference, meta = (AllowPrivateAccess = "true"))
 	FVector ClimbVelocity;	// 攀爬速度
 	void GetClimbVelocity();	// 获取攀爬速度
-	
+
+	/**
+	 * Climb Limb IK （攀爬四肢 IK：目标由移动组件已经拟合的表面和命中推导，不为每个肢体每帧检测）
+	 * 游戏线程只拷贝表面数据并收发细化检测，目标在工作线程上计算
+	 * 命中覆盖不到的肢体偶尔做一次异步细化检测，每次最多一个肢体，结果在下一帧收取
+	 */
+	void GatherClimbLimbIKInputs();						// 游戏线程：拷贝表面数据
+	void UpdateClimbLimbRefinement();					// 游戏线程：收取并发起细化检测
+	void UpdateClimbLimbIKTargets(float DeltaSeconds);	// 工作线程：计算目标
+	void FitClimbSurfaceAt(const FVector& Location, FVector& OutPoint, FVector& OutNormal, float& OutCoverageDistance) const;	// 附近命中加权得到的局部平面
+	FVector GetClimbLimbRestOffset(EClimbLimb Limb) const;	// 肢体在角色空间中的基准位置
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	bool bEnableClimbLimbIK = true;		// 是否计算攀爬四肢 IK
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	FVector ClimbHandRestOffset = FVector(0.f, 25.f, 55.f);	// 右手在角色空间中的基准位置（左手镜像 Y）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	FVector ClimbFootRestOffset = FVector(0.f, 15.f, -75.f);	// 右脚在角色空间中的基准位置（左脚镜像 Y）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	float ClimbLimbSurfaceOffset = 4.f;		// 目标离开表面的距离（手掌和鞋底的厚度）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	float ClimbLimbInterpSpeed = 15.f;		// 目标在角色空间中的插值速度
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	float ClimbLimbAlphaInterpSpeed = 8.f;	// IK 权重的插值速度
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	float ClimbLimbSampleCoverage = 40.f;	// 离最近的表面命中超过该距离的肢体需要细化检测
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	float ClimbLimbRefineInterval = 0.1f;	// 两次细化检测的最小间隔（所有肢体共享）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	float ClimbLimbRefineLifetime = 0.5f;	// 细化结果的有效时间
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	float ClimbLimbRefineDistance = 30.f;	// 细化检测沿法线前后的距离
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	FClimbLimbIKTarget ClimbHandLeftIK;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	FClimbLimbIKTarget ClimbHandRightIK;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	FClimbLimbIKTarget ClimbFootLeftIK;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climb IK", meta = (AllowPrivateAccess = "true"))
+	FClimbLimbIKTarget ClimbFootRightIK;
+
+	FClimbLimbIKTarget& GetClimbLimbIKTarget(EClimbLimb Limb);
+
+	FClimbLimbIKInputs ClimbLimbIKInputs;
+
+	static constexpr int32 NumClimbLimbs = static_cast<int32>(EClimbLimb::MAX);
+
+	// 工作线程写入，下一帧的游戏线程读取（动画更新在下一帧之前完成）
+	FVector ClimbLimbLocalTargets[NumClimbLimbs];		// 插值中的目标（角色空间）
+	FVector ClimbLimbPlanePoints[NumClimbLimbs];		// 细化前的目标点（世界空间）
+	FVector ClimbLimbPlaneNormals[NumClimbLimbs];
+	bool bClimbLimbNeedsRefine[NumClimbLimbs] = {};
+
+	FClimbLimbRefinement ClimbLimbRefinements[NumClimbLimbs];
+	float ClimbLimbTime = 0.f;
+
+	FTraceHandle ClimbLimbRefineTrace;			// 正在进行的细化检测
+	int32 ClimbLimbRefineTraceLimb = INDEX_NONE;
+	int32 NextClimbLimbToRefine = 0;			// 轮询的起点
+	float LastClimbLimbRefineTime = -UE_BIG_NUMBER;
 };
@@ -0,0 +1,22 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ClimbTelemetryHeatmapCommandlet.generated.h"
+
+/**
+ * 把攀爬遥测文件聚合成每张地图的空间热力图（俯视网格，CSV）
+ * 用法：UnrealEditor-Cmd <Project> -run=ClimbTelemetryHeatmap [-Input=<目录>] [-Output=<目录>] [-CellSize=200]
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API UClimbTelemetryHeatmapCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UClimbTelemetryHeatmapCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,15 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+// 攀爬检测通道，在 DefaultEngine.ini 中定义为 GameTraceChannel1，默认忽略；只有攀爬碰撞代理阻挡它
+#define ECC_Climb ECC_GameTraceChannel1
+
+namespace CS_ClimbCollision
+{
+	// 攀爬碰撞代理的碰撞预设：只响应攀爬检测通道，不参与角色移动和其他检测
+	inline const FName ProxyProfileName = TEXT("ClimbProxy");
+}
@@ -0,0 +1,90 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/AssetUserData.h"
+#include "PhysicsEngine/AggregateGeom.h"
+#include "ClimbCollisionProxyComponent.generated.h"
+
+class UBodySetup;
+class UStaticMesh;
+
+// 代理几何的来源
+UENUM()
+enum class EClimbProxySource : uint8
+{
+	Auto,				// 依次使用网格资源上的代理数据、网格简单碰撞、渲染网格凸包、包围盒
+	AssetUserData,		// 只使用网格资源上的 UClimbCollisionProxyUserData
+	SimpleCollision,	// 复制网格的简单碰撞（盒体、球体、胶囊体、凸包）
+	RenderMeshHull,		// 由渲染网格顶点生成一个凸包
+	Bounds				// 网格局部包围盒
+};
+
+/**
+ * 按网格资源编写的攀爬碰撞代理，挂在静态网格资源的 Asset User Data 上
+ * 同一个网格的所有实例共享，代理组件优先使用它
+ */
+UCLASS(meta = (DisplayName = "Climb Collision Proxy"))
+class CLIMBINGSYSTEM_API UClimbCollisionProxyUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Climb Proxy")
+	FKAggregateGeom ProxyGeometry;		// 网格局部空间的盒体和凸包
+};
+
+/**
+ * 简化的攀爬碰撞代理
+ * 挂在静态网格组件下（相对变换为单位变换），只阻挡攀爬检测通道，攀爬检测命中它而不是网格的复杂碰撞
+ * 代理几何在注册时按来源生成一次，之后只在网格改变时重建
+ */
+UCLASS(ClassGroup = (Climbing), meta = (BlueprintSpawnableComponent))
+class CLIMBINGSYSTEM_API UClimbCollisionProxyComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UClimbCollisionProxyComponent(const FObjectInitializer& ObjectInitializer);
+
+	virtual UBodySetup* GetBodySetup() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+	// 重新从来源生成代理几何
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Climb Proxy")
+	void RebuildProxy();
+
+	int32 GetNumProxyElements() const;
+
+protected:
+	virtual void OnRegister() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	UStaticMesh* GetSourceMesh() const;
+	void BuildProxyGeometry();
+
+	static bool BuildFromAssetUserData(UStaticMesh* Mesh, FKAggregateGeom& OutGeometry);
+	static bool BuildFromSimpleCollision(const UStaticMesh* Mesh, FKAggregateGeom& OutGeometry);
+	static bool BuildFromRenderMeshHull(const UStaticMesh* Mesh, int32 MaxHullVertices, FKAggregateGeom& OutGeometry);
+	static bool BuildFromBounds(const UStaticMesh* Mesh, FKAggregateGeom& OutGeometry);
+
+	UPROPERTY(EditAnywhere, Category = "Climb Proxy")
+	EClimbProxySource ProxySource = EClimbProxySource::Auto;
+
+	UPROPERTY(EditAnywhere, Category = "Climb Proxy")
+	UStaticMesh* SourceMesh;	// 为空时使用父静态网格组件的网格
+
+	UPROPERTY(EditAnywhere, Category = "Climb Proxy", meta = (ClampMin = "8"))
+	int32 MaxHullVertices = 32;	// 渲染网格凸包的最大顶点数（从最低 LOD 均匀抽样）
+
+	UPROPERTY(Transient, DuplicateTransient)
+	UBodySetup* ProxyBodySetup;
+
+	TWeakObjectPtr<UStaticMesh> BuiltFromMesh;	// 上一次生成时使用的网格
+};
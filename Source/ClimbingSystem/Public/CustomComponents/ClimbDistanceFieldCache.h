@@ -0,0 +1,82 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPrimitiveComponent;
+
+namespace CS_ClimbTrace
+{
+	struct FTraceContext;
+}
+
+// 距离场缓存统计
+struct FClimbDistanceFieldStats
+{
+	int32 ResidentBricks = 0;		// 当前驻留的砖块数
+	int32 BricksRequested = 0;		// 累计请求的砖块数
+	int32 BricksEvicted = 0;		// 累计淘汰的砖块数
+	int32 SamplesComputed = 0;		// 累计计算的体素采样数
+	int32 QueryHits = 0;			// 查询命中（砖块可用）
+	int32 QueryMisses = 0;			// 查询未命中（砖块未就绪、包含可移动物体或不支持）
+
+	float GetHitRate() const
+	{
+		const int32 TotalQueries = QueryHits + QueryMisses;
+		return TotalQueries > 0 ? static_cast<float>(QueryHits) / TotalQueries : 0.f;
+	}
+};
+
+// 一个稀疏砖块：(Resolution+1)^3 个角点采样，三线性插值不需要跨砖块
+struct FClimbDistanceFieldBrick
+{
+	TArray<float> Distances;
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> Components;	// 请求时收集一次的重叠组件
+	int32 NextSampleIndex = 0;		// 分帧构建的进度
+	bool bReady = false;			// 所有采样已经计算完成
+	bool bUsable = true;			// 包含可移动物体或者无法计算距离时不可用，查询回退到物理检测
+};
+
+/**
+ * 角色周围的稀疏距离场砖块缓存
+ * 从碰撞几何体分帧构建（只处理静态物体），查询时做三线性插值，代替攀爬时的物理检测
+ */
+class CLIMBINGSYSTEM_API FClimbDistanceFieldCache
+{
+public:
+	void Initialize(float InVoxelSize, int32 InBrickResolution, float InMaxDistance);
+
+	// 请求角色周围的砖块、淘汰远处的砖块，并在采样预算内继续构建未完成的砖块
+	void Update(const CS_ClimbTrace::FTraceContext& TraceContext, const FVector& Center, float Radius, const FCollisionQueryParams& QueryParams, int32 MaxBrickRequests, int32 SampleBudget);
+
+	void Reset();
+
+	// 三线性插值采样到最近表面的距离，砖块不可用时返回false
+	bool SampleDistance(const FVector& Location, float& OutDistance) const;
+
+	// 采样最近的表面点和法线（距离场梯度）
+	bool SampleSurface(const FVector& Location, FVector& OutSurfacePoint, FVector& OutSurfaceNormal) const;
+
+	// 沿线段做球面步进，返回true表示距离场给出了结果（OutHit.bBlockingHit表示是否命中），false表示需要回退到物理检测
+	bool LineTrace(const FVector& Start, const FVector& End, FHitResult& OutHit) const;
+
+	FORCEINLINE const FClimbDistanceFieldStats& GetStats() const { return Stats; }
+
+	SIZE_T GetAllocatedSize() const;	// 缓存占用的内存
+
+private:
+	FIntVector GetBrickCoord(const FVector& Location) const;
+	FVector GetBrickOrigin(const FIntVector& BrickCoord) const;
+	void RequestBrick(const CS_ClimbTrace::FTraceContext& TraceContext, const FIntVector& BrickCoord, const FCollisionQueryParams& QueryParams);
+	int32 BuildBrick(FClimbDistanceFieldBrick& Brick, const FIntVector& BrickCoord, int32 SampleBudget);
+
+	TMap<FIntVector, FClimbDistanceFieldBrick> Bricks;
+
+	float VoxelSize = 20.f;
+	int32 BrickResolution = 4;
+	float BrickWorldSize = 80.f;
+	float MaxDistance = 100.f;
+
+	mutable FClimbDistanceFieldStats Stats;
+};
@@ -0,0 +1,24 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ALandscapeProxy;
+class UPrimitiveComponent;
+
+/**
+ * 地形（Landscape）攀爬快速路径
+ * 直接从地形的碰撞高度场数据中采样高度和法线，代替对高度场碰撞的物理扫描
+ */
+namespace CS_ClimbLandscape
+{
+	// 采样地形在某一水平位置的高度（世界坐标），不在地形范围内返回false
+	bool SampleHeight(const ALandscapeProxy* Landscape, const FVector& Location, float& OutHeight);
+
+	// 采样地形在某一水平位置的表面点和法线（中心差分）
+	bool SampleSurface(const ALandscapeProxy* Landscape, const FVector& Location, FVector& OutSurfacePoint, FVector& OutSurfaceNormal);
+
+	// 沿线段对高度场做步进求交，结果填充为和物理检测一致的FHitResult
+	bool LineTrace(const ALandscapeProxy* Landscape, UPrimitiveComponent* HitComponent, const FVector& Start, const FVector& End, FHitResult& OutHit);
+}
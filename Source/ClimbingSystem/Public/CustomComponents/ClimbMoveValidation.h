@@ -0,0 +1,141 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbMoveValidation.generated.h"
+
+class UPrimitiveComponent;
+
+// 客户端请求的攀爬动作
+UENUM()
+enum class EClimbMoveType : uint8
+{
+	StartClimb,		// 上墙
+	Dash,			// 攀爬冲刺
+	Vault			// 翻越
+};
+
+// 客户端声明的攀爬动作：使用的表面点和目标点，服务器据此校验
+USTRUCT()
+struct FClimbMoveClaim
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	EClimbMoveType MoveType = EClimbMoveType::StartClimb;
+
+	UPROPERTY()
+	UPrimitiveComponent* SurfaceComponent = nullptr;	// 攀爬表面 / 冲刺目标 / 翻越起点所在的组件
+
+	UPROPERTY()
+	FVector_NetQuantize SurfacePoint;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal SurfaceNormal;
+
+	UPROPERTY()
+	UPrimitiveComponent* TargetComponent = nullptr;		// 翻越落点所在的组件
+
+	UPROPERTY()
+	FVector_NetQuantize TargetPoint;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal TargetNormal;
+
+	UPROPERTY()
+	int8 DashDirectionIndex = INDEX_NONE;				// 冲刺方向在 ClimbDashDirections 中的下标
+};
+
+// 几何缓存的快速校验结果
+enum class EClimbGeometryCheck : uint8
+{
+	Accepted,		// 落在已验证过的表面采样附近
+	Rejected,		// 明显不在组件上（超出包围盒）
+	Unknown			// 缓存无法判断，需要完整检测
+};
+
+// 校验统计
+struct FClimbValidationStats
+{
+	int32 CheapAccepted = 0;		// 只用缓存通过的请求
+	int32 CheapRejected = 0;		// 只用缓存拒绝的请求
+	int32 FullTraceValidations = 0;	// 回退到完整检测的请求
+	int32 Rejected = 0;				// 完整检测后仍然拒绝的请求
+	int32 CachedPrimitives = 0;
+	int32 CachedSamples = 0;
+};
+
+// 一个已验证的表面采样（组件局部空间）
+struct FClimbSurfaceSample
+{
+	FVector3f Point;
+	FVector3f Normal;
+};
+
+// 单个组件的缓存：缓存时的变换、局部包围盒和按格子索引的表面采样
+struct FClimbPrimitiveGeometry
+{
+	FTransform ComponentToWorld;
+	FBox LocalBounds;
+	TMap<FIntVector, FClimbSurfaceSample> Samples;
+};
+
+/**
+ * 按组件缓存的可攀爬几何
+ * 完整检测确认过的表面点以局部空间写入缓存，之后客户端声明的点只需要在容差范围内查找采样，不做物理检测
+ * 只缓存静态组件，组件变换变化时丢弃它的缓存
+ */
+class CLIMBINGSYSTEM_API FClimbGeometryCache
+{
+public:
+	void Initialize(float InCellSize, int32 InMaxSamplesPerPrimitive, int32 InMaxPrimitives);
+
+	void Reset();
+
+	// 快速校验声明的表面点和法线
+	EClimbGeometryCheck CheckSurfacePoint(const UPrimitiveComponent* Component, const FVector& Point, const FVector& Normal, float Tolerance, float MinNormalDot);
+
+	// 写入完整检测确认过的表面点
+	void AddSurfaceSample(const UPrimitiveComponent* Component, const FVector& Point, const FVector& Normal);
+
+	FORCEINLINE FClimbValidationStats& GetStats() { return Stats; }
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	static bool IsCacheable(const UPrimitiveComponent* Component);
+	FClimbPrimitiveGeometry* FindEntry(const UPrimitiveComponent* Component);
+	FIntVector GetCellCoord(const FVector& LocalPoint) const;
+
+	TMap<TWeakObjectPtr<const UPrimitiveComponent>, FClimbPrimitiveGeometry> Primitives;
+
+	float CellSize = 25.f;
+	int32 MaxSamplesPerPrimitive = 256;
+	int32 MaxPrimitives = 1024;
+
+	FClimbValidationStats Stats;
+};
+
+/**
+ * 服务器上所有角色共享的攀爬校验缓存
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API UClimbValidationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	FClimbGeometryCache& GetGeometryCache() { return GeometryCache; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	FClimbGeometryCache GeometryCache;
+};
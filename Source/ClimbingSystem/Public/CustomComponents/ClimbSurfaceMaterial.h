@@ -0,0 +1,87 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "UObject/ObjectKey.h"
+#include "ClimbSurfaceMaterial.generated.h"
+
+struct FHitResult;
+
+// 攀爬表面属性，由命中的物理材质决定
+USTRUCT(BlueprintType)
+struct FClimbSurfaceProperties
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Surface")
+	bool bClimbable = true;					// 是否可以攀爬（不可攀爬的命中在检测后被剔除）
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Surface", meta = (ClampMin = "0.0"))
+	float SpeedMultiplier = 1.f;			// 最大攀爬速度倍率
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Surface", meta = (ClampMin = "0.0"))
+	float AccelerationMultiplier = 1.f;		// 最大攀爬加速度倍率
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Surface")
+	bool bAllowDash = true;					// 是否允许攀爬冲刺
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Surface", meta = (ClampMin = "0.0", Units = "s"))
+	float GripLossTime = 0.f;				// 在这种表面上连续攀爬多久后脱手，0 表示不会脱手
+
+	// 多个命中时取最严格的组合
+	void CombineMostRestrictive(const FClimbSurfaceProperties& Other)
+	{
+		bClimbable &= Other.bClimbable;
+		SpeedMultiplier = FMath::Min(SpeedMultiplier, Other.SpeedMultiplier);
+		AccelerationMultiplier = FMath::Min(AccelerationMultiplier, Other.AccelerationMultiplier);
+		bAllowDash &= Other.bAllowDash;
+		GripLossTime = GripLossTime > 0.f && Other.GripLossTime > 0.f ? FMath::Min(GripLossTime, Other.GripLossTime) : FMath::Max(GripLossTime, Other.GripLossTime);
+	}
+};
+
+/**
+ * 带攀爬属性的物理材质
+ * 直接替换表面的物理材质即可，不使用这个类的材质可以在移动组件的 ClimbSurfaceMaterialOverrides 中配置
+ */
+UCLASS(BlueprintType)
+class CLIMBINGSYSTEM_API UClimbPhysicalMaterial : public UPhysicalMaterial
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climbing")
+	FClimbSurfaceProperties ClimbSurface;
+};
+
+/**
+ * 按物理材质缓存解析后的攀爬属性
+ * 每个材质只做一次类型转换和覆盖表查找，连续命中同一材质时连哈希查找也跳过
+ */
+class CLIMBINGSYSTEM_API FClimbSurfaceMaterialCache
+{
+public:
+	void Initialize(const TMap<UPhysicalMaterial*, FClimbSurfaceProperties>& InOverrides, const FClimbSurfaceProperties& InDefaultProperties);
+
+	void Reset();
+
+	// 解析命中的攀爬属性：优先使用命中返回的物理材质，没有时使用组件的简单碰撞材质
+	const FClimbSurfaceProperties& Resolve(const FHitResult& Hit) const;
+
+	const FClimbSurfaceProperties& Resolve(const UPhysicalMaterial* Material) const;
+
+	const FClimbSurfaceProperties& GetDefaultProperties() const { return DefaultProperties; }
+
+	int32 GetNum() const { return Resolved.Num(); }
+
+	SIZE_T GetAllocatedSize() const { return Resolved.GetAllocatedSize() + Overrides.GetAllocatedSize(); }
+
+private:
+	TMap<TObjectKey<UPhysicalMaterial>, FClimbSurfaceProperties> Overrides;
+	FClimbSurfaceProperties DefaultProperties;
+
+	mutable TMap<TObjectKey<UPhysicalMaterial>, FClimbSurfaceProperties> Resolved;
+	mutable TObjectKey<UPhysicalMaterial> LastMaterial;
+	mutable const FClimbSurfaceProperties* LastProperties = nullptr;
+};
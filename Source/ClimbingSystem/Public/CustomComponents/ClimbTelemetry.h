@@ -0,0 +1,81 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+// 遥测事件类型，写入文件后不能改变顺序
+enum class EClimbTelemetryEvent : uint8
+{
+	FrameCost,			// 一帧的检测次数和耗时
+	ClimbStart,			// 开始上墙
+	ClimbStartFailed,	// 主动尝试上墙但 CanStartClimbing 失败
+	Dash,				// 攀爬冲刺
+	DashRejected,		// 有输入但没有可用的冲刺方向
+	Vault,				// 翻越
+	TopOut,				// 爬到顶端
+	MoveRejected,		// 服务器拒绝客户端的攀爬动作
+	GripLost,			// 在湿滑表面上抓握时间耗尽而脱手
+
+	MAX
+};
+
+// 单条遥测记录
+struct FClimbTelemetryRecord
+{
+	float Time = 0.f;
+	FVector3f Location = FVector3f::ZeroVector;
+	EClimbTelemetryEvent Event = EClimbTelemetryEvent::FrameCost;
+	uint16 NumTraces = 0;
+	float CostMicroseconds = 0.f;
+};
+
+/**
+ * 列式数据块：每一列连续存储，写入和聚合时只需要按列整块读写
+ * 文件格式：文件头（Magic、Version、地图名），之后是若干数据块（Magic、记录数、各列数据）
+ */
+struct CLIMBINGSYSTEM_API FClimbTelemetryChunk
+{
+	static constexpr uint32 FileMagic = 0x4D544C43;		// "CLTM"
+	static constexpr uint32 ChunkMagic = 0x4B4E4843;	// "CHNK"
+	static constexpr uint32 Version = 1;
+	static constexpr int32 Capacity = 4096;
+
+	TArray<float> Times;
+	TArray<float> LocationX;
+	TArray<float> LocationY;
+	TArray<float> LocationZ;
+	TArray<uint8> Events;
+	TArray<uint16> NumTraces;
+	TArray<float> Costs;
+
+	FClimbTelemetryChunk();
+
+	int32 Num() const { return Times.Num(); }
+	bool IsFull() const { return Num() >= Capacity; }
+
+	void Add(const FClimbTelemetryRecord& Record);
+	FClimbTelemetryRecord Get(int32 Index) const;
+
+	// 读写一个数据块（包括块头），读取失败返回false
+	bool Serialize(FArchive& Ar);
+};
+
+namespace CS_ClimbTelemetry
+{
+	// climb.Telemetry 或者 -ClimbTelemetry 启动参数开启
+	CLIMBINGSYSTEM_API bool IsEnabled();
+
+	// 记录一条事件，只在游戏线程上调用；数据块写满后交给后台线程写入文件
+	CLIMBINGSYSTEM_API void Record(const UWorld* World, EClimbTelemetryEvent Event, const FVector& Location, uint16 NumTraces = 0, float CostMicroseconds = 0.f);
+
+	// 把当前未满的数据块交给后台线程
+	CLIMBINGSYSTEM_API void Flush();
+
+	// 读取一个遥测文件，按数据块回调
+	CLIMBINGSYSTEM_API bool ReadFile(const FString& FilePath, FString& OutMapName, TFunctionRef<void(const FClimbTelemetryChunk&)> ChunkCallback);
+
+	CLIMBINGSYSTEM_API FString GetTelemetryDirectory();
+}
@@ -0,0 +1,191 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "DrawDebugHelpers.h"
+#include "Components/SceneComponent.h"
+#include "Engine/HitResult.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "CustomComponents/ClimbVisualLogger.h"
+#include "CustomComponents/ClimbingMemory.h"
+
+/**
+ * 攀爬检测内核：形状、轴和调试策略都在编译期选择
+ * 默认的 FNoDebug 实例中没有任何调试分支，Shipping 中所有调试策略都退化为 FNoDebug
+ */
+namespace CS_ClimbTrace
+{
+	// 调试策略
+	struct FNoDebug
+	{
+		static constexpr bool bDraw = false;
+		static constexpr bool bPersistent = false;
+	};
+
+	struct FDebugForDuration
+	{
+		static constexpr bool bDraw = ENABLE_DRAW_DEBUG != 0;
+		static constexpr bool bPersistent = false;
+	};
+
+	struct FDebugPersistent
+	{
+		static constexpr bool bDraw = ENABLE_DRAW_DEBUG != 0;
+		static constexpr bool bPersistent = true;
+	};
+
+	// 轴策略：眼睛高度沿哪个方向偏移（竖直攀爬用上方向，横向攀爬用右方向）
+	struct FUpAxis
+	{
+		static FVector GetOffsetAxis(const USceneComponent& Component) { return Component.GetUpVector(); }
+	};
+
+	struct FRightAxis
+	{
+		static FVector GetOffsetAxis(const USceneComponent& Component) { return Component.GetRightVector(); }
+	};
+
+	// 查询参数，每个组件在 BeginPlay 中构建一次，不再每次检测时转换对象类型
+	// TraceChannel 有效时按攀爬检测通道查询，只命中攀爬碰撞代理，否则按对象类型查询
+	struct FTraceContext
+	{
+		const UWorld* World = nullptr;
+		const UObject* LogOwner = nullptr;
+		FCollisionObjectQueryParams ObjectParams;
+		ECollisionChannel TraceChannel = ECC_MAX;
+		FCollisionQueryParams QueryParams;
+		FCollisionQueryParams MaterialQueryParams;	// 同 QueryParams，但返回物理材质（只有攀爬表面检测需要）
+		mutable uint32 NumTraces = 0;	// 检测次数，由组件每帧清零（遥测和浸泡测试使用）
+
+		bool UsesTraceChannel() const { return TraceChannel != ECC_MAX; }
+
+		bool IsValid() const { return World && (UsesTraceChannel() || ObjectParams.IsValid()); }
+
+		const FCollisionQueryParams& GetQueryParams(bool bReturnPhysicalMaterial) const { return bReturnPhysicalMaterial ? MaterialQueryParams : QueryParams; }
+
+		// 宽相重叠查询，和检测使用同样的通道或对象类型
+		void OverlapMulti(TArray<FOverlapResult>& OutOverlaps, const FVector& Center, const FCollisionShape& Shape, const FCollisionQueryParams& Params) const
+		{
+			if (UsesTraceChannel())
+			{
+				World->OverlapMultiByChannel(OutOverlaps, Center, FQuat::Identity, TraceChannel, Shape, Params);
+			}
+			else
+			{
+				World->OverlapMultiByObjectType(OutOverlaps, Center, FQuat::Identity, ObjectParams, Shape, Params);
+			}
+		}
+	};
+
+	// 形状策略：单条射线，返回第一个阻挡
+	struct FLineSingle
+	{
+		using FResult = FHitResult;
+
+		FResult Trace(const FTraceContext& Context, const FVector& Start, const FVector& End) const
+		{
+			FHitResult Hit;
+			if (Context.UsesTraceChannel())
+			{
+				Context.World->LineTraceSingleByChannel(Hit, Start, End, Context.TraceChannel, Context.QueryParams);
+			}
+			else
+			{
+				Context.World->LineTraceSingleByObjectType(Hit, Start, End, Context.ObjectParams, Context.QueryParams);
+			}
+			CLIMB_VLOG_LINE_TRACE(Context.LogOwner, Start, End, Hit);
+			return Hit;
+		}
+
+		void DrawDebug(const UWorld* World, const FVector& Start, const FVector& End, const FResult& Hit, bool bPersistent) const
+		{
+			if (Hit.bBlockingHit)
+			{
+				DrawDebugLine(World, Start, Hit.ImpactPoint, FColor::Red, bPersistent, 5.f);
+				DrawDebugLine(World, Hit.ImpactPoint, End, FColor::Green, bPersistent, 5.f);
+				DrawDebugPoint(World, Hit.ImpactPoint, 16.f, FColor::Red, bPersistent, 5.f);
+			}
+			else
+			{
+				DrawDebugLine(World, Start, End, FColor::Red, bPersistent, 5.f);
+			}
+		}
+	};
+
+	// 形状策略：胶囊体扫描，返回所有命中
+	struct FCapsuleMulti
+	{
+		using FResult = TArray<FHitResult>;
+
+		float Radius = 0.f;
+		float HalfHeight = 0.f;
+		bool bReturnPhysicalMaterial = false;
+
+		FCapsuleMulti(float InRadius, float InHalfHeight, bool bInReturnPhysicalMaterial = false)
+			: Radius(InRadius), HalfHeight(InHalfHeight), bReturnPhysicalMaterial(bInReturnPhysicalMaterial)
+		{
+		}
+
+		FResult Trace(const FTraceContext& Context, const FVector& Start, const FVector& End) const
+		{
+			TArray<FHitResult> Hits;
+			const FCollisionShape Capsule = FCollisionShape::MakeCapsule(Radius, HalfHeight);
+			if (Context.UsesTraceChannel())
+			{
+				Context.World->SweepMultiByChannel(Hits, Start, End, FQuat::Identity, Context.TraceChannel, Capsule, Context.GetQueryParams(bReturnPhysicalMaterial));
+			}
+			else
+			{
+				Context.World->SweepMultiByObjectType(Hits, Start, End, FQuat::Identity, Context.ObjectParams, Capsule, Context.GetQueryParams(bReturnPhysicalMaterial));
+			}
+			CLIMB_VLOG_CAPSULE_TRACE(Context.LogOwner, Start, End, Radius, HalfHeight, Hits);
+			CS_ClimbMemory::NoteArray(Hits);
+			return Hits;
+		}
+
+		void DrawDebug(const UWorld* World, const FVector& Start, const FVector& End, const FResult& Hits, bool bPersistent) const
+		{
+			const FColor Color = Hits.IsEmpty() ? FColor::Red : FColor::Green;
+			DrawDebugCapsule(World, Start, HalfHeight, Radius, FQuat::Identity, Color, bPersistent, 5.f);
+			DrawDebugCapsule(World, End, HalfHeight, Radius, FQuat::Identity, Color, bPersistent, 5.f);
+			DrawDebugLine(World, Start, End, Color, bPersistent, 5.f);
+			for (const FHitResult& Hit : Hits)
+			{
+				DrawDebugPoint(World, Hit.ImpactPoint, 16.f, FColor::Red, bPersistent, 5.f);
+			}
+		}
+	};
+
+	// 组合形状和调试策略的检测内核
+	template <typename DebugPolicy, typename ShapePolicy>
+	typename ShapePolicy::FResult Trace(const FTraceContext& Context, const ShapePolicy& Shape, const FVector& Start, const FVector& End)
+	{
+		if (!Context.IsValid())
+		{
+			// 没有配置检测对象类型或通道
+			return typename ShapePolicy::FResult();
+		}
+
+		typename ShapePolicy::FResult Result = Shape.Trace(Context, Start, End);
+		Context.NumTraces++;
+
+		if constexpr (DebugPolicy::bDraw)
+		{
+			Shape.DrawDebug(Context.World, Start, End, Result, DebugPolicy::bPersistent);
+		}
+
+		return Result;
+	}
+
+	// 眼睛高度检测的起点和终点
+	template <typename AxisPolicy>
+	void GetEyeHeightSegment(const USceneComponent& Component, float EyeHeight, float TraceDistance, FVector& OutStart, FVector& OutEnd)
+	{
+		OutStart = Component.GetComponentLocation() + AxisPolicy::GetOffsetAxis(Component) * EyeHeight;
+		OutEnd = OutStart + Component.GetForwardVector() * TraceDistance;
+	}
+}
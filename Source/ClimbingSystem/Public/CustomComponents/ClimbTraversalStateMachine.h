@@ -0,0 +1,121 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "ClimbTraversalStateMachine.generated.h"
+
+// 攀爬遍历状态
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "false"))
+enum class EClimbTraversalState : uint8
+{
+	Idle UMETA(DisplayName = "Idle"),				// 地面静止
+	Approaching UMETA(DisplayName = "Approaching"),	// 地面移动，可能接近墙面或边缘
+	Mounting UMETA(DisplayName = "Mounting"),		// 上墙或下爬蒙太奇
+	Climbing UMETA(DisplayName = "Climbing"),		// 攀爬、挂边和攀爬路径
+	Dashing UMETA(DisplayName = "Dashing"),			// 攀爬冲刺蒙太奇
+	ToppingOut UMETA(DisplayName = "Topping Out"),	// 爬上顶端蒙太奇
+	Vaulting UMETA(DisplayName = "Vaulting"),		// 翻越蒙太奇
+	Dropping UMETA(DisplayName = "Dropping"),		// 下落（包括蹬墙跳）
+
+	MAX UMETA(Hidden)
+};
+
+// 每个状态可以声明的检测
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "false"))
+enum class EClimbProbe : uint8
+{
+	ClimbableSurface UMETA(DisplayName = "Climbable Surface"),	// 攀爬表面
+	ReachableGround UMETA(DisplayName = "Reachable Ground"),	// 向下爬到地面
+	TopOut UMETA(DisplayName = "Top Out"),						// 到达顶端
+	Corner UMETA(DisplayName = "Corner"),						// 墙角
+	StartClimb UMETA(DisplayName = "Start Climb"),				// 前方可以开始攀爬
+	ClimbDownLedge UMETA(DisplayName = "Climb Down Ledge"),		// 前方边缘可以下爬
+	Vault UMETA(DisplayName = "Vault"),							// 前方可以翻越
+	WallRegrab UMETA(DisplayName = "Wall Regrab"),				// 蹬墙跳后重新抓墙
+
+	MAX UMETA(Hidden)
+};
+
+// 状态描述（数据表行）
+USTRUCT(BlueprintType)
+struct FClimbTraversalStateRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Traversal")
+	EClimbTraversalState State = EClimbTraversalState::Idle;
+
+	// 这个状态下运行的检测
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Traversal", meta = (Bitmask, BitmaskEnum = "/Script/ClimbingSystem.EClimbProbe"))
+	int32 Probes = 0;
+
+	// 可以主动切换到的状态
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Traversal", meta = (Bitmask, BitmaskEnum = "/Script/ClimbingSystem.EClimbTraversalState"))
+	int32 AllowedTransitions = 0;
+};
+
+// 每个状态的统计
+struct FClimbTraversalStateStats
+{
+	double ResidencyTime = 0.0;		// 累计停留时间
+	int32 Entries = 0;				// 进入次数
+	int32 UnexpectedEntries = 0;	// 不在上一个状态允许列表中的进入次数（由移动模式或蒙太奇直接导致）
+	int32 ProbeCounts[static_cast<int32>(EClimbProbe::MAX)] = {};	// 每种检测的运行次数
+
+	int32 GetTotalProbeCount() const
+	{
+		int32 Total = 0;
+		for (const int32 Count : ProbeCounts)
+		{
+			Total += Count;
+		}
+		return Total;
+	}
+};
+
+/**
+ * 数据驱动的攀爬遍历状态机
+ * 每个状态只声明需要的检测和允许的切换，入口函数只运行当前状态声明的检测
+ */
+class CLIMBINGSYSTEM_API FClimbTraversalStateMachine
+{
+public:
+	// 从数据表读取状态描述，没有数据表或者缺少某个状态时使用默认描述
+	void Initialize(const UDataTable* StateTable);
+
+	EClimbTraversalState GetState() const { return State; }
+
+	// 当前状态是否允许主动切换到目标状态
+	bool CanTransitionTo(EClimbTraversalState NewState) const;
+
+	// 主动切换，当前状态不允许时返回false
+	bool TransitionTo(EClimbTraversalState NewState);
+
+	// 同步由移动模式或蒙太奇决定的状态，不允许的切换只记录到统计中
+	void SyncState(EClimbTraversalState ObservedState);
+
+	// 当前状态是否声明了这个检测，声明时记录一次检测
+	bool WantsProbe(EClimbProbe Probe);
+
+	void Tick(float DeltaTime);
+
+	const FClimbTraversalStateStats& GetStats(EClimbTraversalState InState) const { return Stats[static_cast<int32>(InState)]; }
+
+	void ResetStats();
+
+	FString DescribeStats() const;
+
+	static const TCHAR* GetStateName(EClimbTraversalState InState);
+
+private:
+	void EnterState(EClimbTraversalState NewState, bool bExpected);
+
+	static FClimbTraversalStateRow MakeDefaultRow(EClimbTraversalState InState);
+
+	EClimbTraversalState State = EClimbTraversalState::Idle;
+
+	FClimbTraversalStateRow Rows[static_cast<int32>(EClimbTraversalState::MAX)];
+	FClimbTraversalStateStats Stats[static_cast<int32>(EClimbTraversalState::MAX)];
+};
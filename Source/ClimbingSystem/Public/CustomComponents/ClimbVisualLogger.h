@@ -0,0 +1,62 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VisualLogger/VisualLogger.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogClimbProbe, Log, All);
+
+// Shipping 中 ENABLE_VISUAL_LOG 为0，所有记录连同参数计算一起被编译掉
+#define CLIMB_VLOG_ENABLED ENABLE_VISUAL_LOG
+
+#if CLIMB_VLOG_ENABLED
+
+/**
+ * 把攀爬检测的几何体和命中结果记录到 Visual Logger
+ * 只在 Visual Logger 录制时记录，并按 climb.VLog.SampleInterval 隔帧采样
+ */
+namespace CS_ClimbVLog
+{
+	// 这一帧是否需要记录
+	CLIMBINGSYSTEM_API bool ShouldRecord();
+
+	// 当前检测的名字，由 FProbeScope 设置，记录时作为标签
+	CLIMBINGSYSTEM_API const TCHAR* GetProbeLabel();
+
+	struct CLIMBINGSYSTEM_API FProbeScope
+	{
+		explicit FProbeScope(const TCHAR* Label);
+		~FProbeScope();
+
+	private:
+		const TCHAR* PreviousLabel;
+	};
+
+	CLIMBINGSYSTEM_API void LineTrace(const UObject* Owner, const FVector& Start, const FVector& End, const FHitResult& Hit);
+	CLIMBINGSYSTEM_API void CapsuleTrace(const UObject* Owner, const FVector& Start, const FVector& End, float Radius, float HalfHeight, const TArray<FHitResult>& Hits);
+	CLIMBINGSYSTEM_API void QueryBounds(const UObject* Owner, const FBox& Bounds, int32 NumComponents);
+	CLIMBINGSYSTEM_API void Surface(const UObject* Owner, const TCHAR* Label, const FVector& Location, const FVector& Normal);
+	CLIMBINGSYSTEM_API void Segment(const UObject* Owner, const TCHAR* Label, const FVector& Start, const FVector& End, const FColor& Color);
+	CLIMBINGSYSTEM_API void Location(const UObject* Owner, const TCHAR* Label, const FVector& Location, const FColor& Color);
+}
+
+#define CLIMB_VLOG_PROBE_SCOPE(Label) const CS_ClimbVLog::FProbeScope ANONYMOUS_VARIABLE(ClimbProbeScope_)(TEXT(Label))
+#define CLIMB_VLOG_LINE_TRACE(Owner, Start, End, Hit) do { if (CS_ClimbVLog::ShouldRecord()) { CS_ClimbVLog::LineTrace(Owner, Start, End, Hit); } } while (0)
+#define CLIMB_VLOG_CAPSULE_TRACE(Owner, Start, End, Radius, HalfHeight, Hits) do { if (CS_ClimbVLog::ShouldRecord()) { CS_ClimbVLog::CapsuleTrace(Owner, Start, End, Radius, HalfHeight, Hits); } } while (0)
+#define CLIMB_VLOG_QUERY_BOUNDS(Owner, Bounds, NumComponents) do { if (CS_ClimbVLog::ShouldRecord()) { CS_ClimbVLog::QueryBounds(Owner, Bounds, NumComponents); } } while (0)
+#define CLIMB_VLOG_SURFACE(Owner, Label, Location, Normal) do { if (CS_ClimbVLog::ShouldRecord()) { CS_ClimbVLog::Surface(Owner, TEXT(Label), Location, Normal); } } while (0)
+#define CLIMB_VLOG_SEGMENT(Owner, Label, Start, End, Color) do { if (CS_ClimbVLog::ShouldRecord()) { CS_ClimbVLog::Segment(Owner, TEXT(Label), Start, End, Color); } } while (0)
+#define CLIMB_VLOG_LOCATION(Owner, Label, Location, Color) do { if (CS_ClimbVLog::ShouldRecord()) { CS_ClimbVLog::Location(Owner, TEXT(Label), Location, Color); } } while (0)
+
+#else
+
+#define CLIMB_VLOG_PROBE_SCOPE(Label)
+#define CLIMB_VLOG_LINE_TRACE(Owner, Start, End, Hit)
+#define CLIMB_VLOG_CAPSULE_TRACE(Owner, Start, End, Radius, HalfHeight, Hits)
+#define CLIMB_VLOG_QUERY_BOUNDS(Owner, Bounds, NumComponents)
+#define CLIMB_VLOG_SURFACE(Owner, Label, Location, Normal)
+#define CLIMB_VLOG_SEGMENT(Owner, Label, Start, End, Color)
+#define CLIMB_VLOG_LOCATION(Owner, Label, Location, Color)
+
+#endif
@@ -0,0 +1,54 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// 攀爬系统的 LLM 标签，运行时使用 -llm 启动后通过 stat LLMFULL 查看
+LLM_DECLARE_TAG_API(Climbing, CLIMBINGSYSTEM_API);					// 组件状态、状态机等
+LLM_DECLARE_TAG_API(Climbing_Probes, CLIMBINGSYSTEM_API);			// 检测命中数组和宽相查询结果
+LLM_DECLARE_TAG_API(Climbing_DistanceField, CLIMBINGSYSTEM_API);	// 距离场砖块
+LLM_DECLARE_TAG_API(Climbing_Trajectories, CLIMBINGSYSTEM_API);		// 冲刺方向和烘焙的根动作轨迹
+
+// 单个角色的攀爬内存占用（字节）
+struct FClimbMemoryUsage
+{
+	SIZE_T ComponentState = 0;	// 移动组件对象本身
+	SIZE_T TraceHits = 0;		// 保留的检测结果数组
+	SIZE_T DashData = 0;		// 冲刺方向和轨迹
+	SIZE_T DistanceField = 0;	// 距离场砖块
+	SIZE_T MotionWarping = 0;	// 运动扭曲组件和目标
+
+	SIZE_T GetTotal() const
+	{
+		return ComponentState + TraceHits + DashData + DistanceField + MotionWarping;
+	}
+};
+
+namespace CS_ClimbMemory
+{
+	// 每帧的分配统计
+	struct FFrameAllocations
+	{
+		uint64 FrameNumber = 0;
+		int32 Count = 0;
+		int64 Bytes = 0;
+	};
+
+	// 记录一次攀爬系统的堆分配，按帧累计
+	CLIMBINGSYSTEM_API void NoteAllocation(int64 Bytes);
+
+	// 数组有堆内存时记录为一次分配
+	template <typename ArrayType>
+	void NoteArray(const ArrayType& Array)
+	{
+		if (Array.Max() > 0)
+		{
+			NoteAllocation(Array.GetAllocatedSize());
+		}
+	}
+
+	// 上一个完整帧的分配统计
+	CLIMBINGSYSTEM_API FFrameAllocations GetLastFrameAllocations();
+}
@@ -3,7 +3,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/DataTable.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "CustomComponents/ClimbDistanceFieldCache.h"
+#include "CustomComponents/ClimbTraversalStateMachine.h"
+#include "CustomComponents/ClimbTraceKernels.h"
+#include "CustomComponents/ClimbCollision.h"
+#include "CustomComponents/ClimbSurfaceMaterial.h"
+#include "CustomComponents/ClimbMoveValidation.h"
+#include "CustomComponents/ClimbTelemetry.h"
 #include "CustomMovementComponent.generated.h"
 
 DECLARE_DELEGATE(FOnEnterClimbState)
@@ -12,6 +20,11 @@ DECLARE_DELEGATE(FOnExitClimbState)
 class UAnimMontage;
 class UCharacterAnimInstance;
 class AClimbingSystemCharacter;
+class AClimbPathActor;
+class ALandscapeProxy;
+class USkeletalMeshComponent;
+enum class EClimbWindowType : uint8;
+struct FClimbMemoryUsage;
 
 UENUM(BlueprintType)
 namespace ECustomMovementMode
@@ -19,9 +32,244 @@ namespace ECustomMovementMode
 	enum Type
 	{
 		MOVE_Climb UMETA(DisplayName = "Climb Mode"),
+		MOVE_Ladder UMETA(DisplayName = "Ladder Mode"),		// 沿样条线攀爬梯子
+		MOVE_Rope UMETA(DisplayName = "Rope Mode"),			// 沿样条线攀爬绳索
+		MOVE_Pipe UMETA(DisplayName = "Pipe Mode"),			// 沿样条线攀爬水管
+		MOVE_Zipline UMETA(DisplayName = "Zipline Mode"),	// 沿样条线滑索
+		MOVE_LedgeHang UMETA(DisplayName = "Ledge Hang Mode"),	// 挂在边缘上横移
 	};
 }
 
+// 攀爬冲刺方向（数据表行）
+USTRUCT(BlueprintType)
+struct FClimbDashDirection : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Dash")
+	FVector2D Direction = FVector2D(0.f, 1.f);		// 攀爬平面内的方向，X为角色右方，Y为角色上方
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Dash")
+	float ProbeDistance = 200.f;	// 目标检测点沿方向离眼睛高度的距离（左右也从眼睛高度出发，不再是旧版的组件高度加 BaseEyeHeight 横向偏移）
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Dash")
+	float SafetyProbeDistance = 0.f;	// 大于0时，沿方向离眼睛高度这么远处也必须有墙面（例如向上冲刺时保证落点上方还能抓住），应大于 ProbeDistance
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Dash")
+	float ForwardTraceDistance = 100.f;	// 每个检测点向前检测墙面的距离
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Dash")
+	UAnimMontage* Montage = nullptr;	// 冲刺蒙太奇
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Climb Dash")
+	FName WarpTargetName;	// 运动扭曲目标名
+};
+
+// 一个冲刺方向的批量查询结果
+struct FClimbDashCandidate
+{
+	bool bValid = false;
+	FVector TargetPoint = FVector::ZeroVector;
+	FVector TargetNormal = FVector::ZeroVector;
+	UPrimitiveComponent* TargetComponent = nullptr;	// 服务器校验冲刺目标时使用
+};
+
+// 预先采样的冲刺根动作轨迹（角色本地空间，第一个点为原点）
+struct FClimbDashTrajectory
+{
+	TArray<FVector> Points;
+};
+
+// 蹬墙跳求解出的落点
+struct FClimbJumpTarget
+{
+	bool bValid = false;
+	FVector GrabLocation = FVector::ZeroVector;		// 抓住墙面时胶囊体中心的位置
+	FVector SurfaceNormal = FVector::ZeroVector;	// 落点墙面法线
+	FVector SurfacePoint = FVector::ZeroVector;		// 落点墙面上的点
+	float ArrivalTime = 0.f;						// 起跳后到达落点的时间
+};
+
+// 抓住边缘时一次性提取的边缘线段
+struct FClimbLedgeSegment
+{
+	FVector Start = FVector::ZeroVector;		// 线段起点（边缘上）
+	FVector End = FVector::ZeroVector;			// 线段终点（边缘上）
+	FVector WallNormal = FVector::ZeroVector;	// 边缘下方墙面的法线
+	float Length = 0.f;
+
+	FVector GetDirection() const { return Length > 0.f ? (End - Start) / Length : FVector::ZeroVector; }
+	FVector GetPointAt(float Distance) const { return Start + GetDirection() * FMath::Clamp(Distance, 0.f, Length); }
+};
+
+// 顶端预测的缓存结果，角色偏离预测时的位置前一直有效
+struct FClimbTopOutPrediction
+{
+	bool bValid = false;					// 缓存是否有效
+	bool bHasLedge = false;					// 预测范围内是否有顶端
+	FVector Origin = FVector::ZeroVector;	// 预测时角色的位置
+	FVector UpVector = FVector::UpVector;	// 预测时角色的上方向
+	FVector WallNormal = FVector::ZeroVector;	// 预测时的墙面法线
+	float LedgeHeight = 0.f;				// 顶端沿上方向的高度
+	float ValidUntilHeight = 0.f;			// 没有顶端时，眼睛高度超过这个值需要重新预测
+	FHitResult LedgeTopHit;					// 顶端表面
+};
+
+// 攀爬蒙太奇播放期间缓存的输入
+enum class EClimbBufferedAction : uint8
+{
+	None,
+	Dash,		// 攀爬冲刺
+	WallJump,	// 蹬墙跳
+};
+
+// 墙角类型
+UENUM(BlueprintType)
+enum class EClimbCornerType : uint8
+{
+	None UMETA(DisplayName = "None"),
+	Inner UMETA(DisplayName = "Inner Corner"),		// 内墙角（前进方向被相邻墙面挡住）
+	Outer UMETA(DisplayName = "Outer Corner"),		// 外墙角（前进方向的墙面向后折走）
+};
+
+// 墙角过渡状态，进入时一次性解析计算路径，过渡期间不再做任何表面检测
+struct FClimbCornerTransition
+{
+	bool bActive = false;
+	EClimbCornerType CornerType = EClimbCornerType::None;
+
+	FVector Pivot = FVector::ZeroVector;			// 墙角棱线上与角色同高的点，绕其旋转
+	FVector StartOffset = FVector::ZeroVector;		// 起点相对Pivot的水平偏移
+	FVector EndOffset = FVector::ZeroVector;		// 终点相对Pivot的水平偏移
+	float SweepAngle = 0.f;							// 绕上向量旋转的总角度（弧度，带符号）
+
+	FQuat StartRotation = FQuat::Identity;
+	FQuat EndRotation = FQuat::Identity;
+
+	FVector EndSurfaceLocation = FVector::ZeroVector;	// 相邻墙面上的点
+	FVector EndSurfaceNormal = FVector::ZeroVector;		// 相邻墙面的法线
+
+	float Duration = 0.f;
+	float Elapsed = 0.f;
+};
+
+// 攀爬状态快照：固定大小、没有堆分配，按值拷贝进环形缓冲区
+// 保存的是一帧模拟结束时 PhysClimb 依赖的全部状态，以及产生这一帧的输入
+struct FClimbSnapshot
+{
+	static constexpr int32 MaxSurfaceHits = 8;
+	static constexpr int32 MaxWarpTargets = 4;
+
+	uint32 Frame = 0;								// 模拟帧号
+	float DeltaTime = 0.f;							// 这一帧的时间
+	FVector Acceleration = FVector::ZeroVector;		// 这一帧的输入加速度
+
+	uint8 MovementMode = 0;
+	uint8 CustomMovementMode = 0;
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector Velocity = FVector::ZeroVector;
+
+	// 攀爬表面和检测结果（只保存重建表面需要的点、法线和组件）
+	FVector SurfaceLocation = FVector::ZeroVector;
+	FVector SurfaceNormal = FVector::ZeroVector;
+	int32 NumSurfaceHits = 0;
+	FVector SurfaceHitPoints[MaxSurfaceHits];
+	FVector SurfaceHitNormals[MaxSurfaceHits];
+	TWeakObjectPtr<UPrimitiveComponent> SurfaceHitComponents[MaxSurfaceHits];
+	FClimbSurfaceProperties SurfaceProperties;
+	float GripTime = 0.f;
+
+	// 当前蒙太奇和通知窗口（缓冲区不被 GC 引用，对象指针都是弱指针，还原时检查）
+	TWeakObjectPtr<UAnimMontage> Montage;
+	float MontagePosition = 0.f;
+	float MontagePlayRate = 1.f;
+	uint8 OpenClimbWindows = 0;
+
+	// 运动扭曲目标
+	int32 NumWarpTargets = 0;
+	FName WarpTargetNames[MaxWarpTargets];
+	FVector WarpTargetLocations[MaxWarpTargets];
+	FQuat WarpTargetRotations[MaxWarpTargets];
+
+	// 子状态
+	FClimbCornerTransition CornerTransition;
+	FClimbLedgeSegment LedgeSegment;
+	float LedgeHangDistance = 0.f;
+	TWeakObjectPtr<AClimbPathActor> ClimbPath;
+	float ClimbPathDistance = 0.f;
+	float ClimbPathSpeed = 0.f;
+	FClimbJumpTarget WallJumpTarget;
+};
+
+// 快照环形缓冲区，帧号连续递增
+class FClimbSnapshotBuffer
+{
+public:
+	void Initialize(int32 Capacity)
+	{
+		Snapshots.SetNum(FMath::Max(Capacity, 1));
+		Reset();
+	}
+
+	void Reset()
+	{
+		Head = INDEX_NONE;
+		Num = 0;
+	}
+
+	// 写入下一帧的快照，覆盖最旧的一帧
+	FClimbSnapshot& Push()
+	{
+		Head = (Head + 1) % Snapshots.Num();
+		Num = FMath::Min(Num + 1, Snapshots.Num());
+		return Snapshots[Head];
+	}
+
+	const FClimbSnapshot* GetLatest() const
+	{
+		return Num > 0 ? &Snapshots[Head] : nullptr;
+	}
+
+	FClimbSnapshot* Find(uint32 Frame)
+	{
+		if (Num == 0 || Frame > Snapshots[Head].Frame)
+		{
+			return nullptr;
+		}
+
+		const uint32 Age = Snapshots[Head].Frame - Frame;
+		if (Age >= static_cast<uint32>(Num))
+		{
+			// 已经被覆盖
+			return nullptr;
+		}
+
+		FClimbSnapshot& Snapshot = Snapshots[(Head - static_cast<int32>(Age) + Snapshots.Num()) % Snapshots.Num()];
+		return Snapshot.Frame == Frame ? &Snapshot : nullptr;
+	}
+
+	// 丢弃某一帧之后的快照，重新模拟时从这一帧之后重新写入
+	void DiscardAfter(uint32 Frame)
+	{
+		if (Num == 0 || Frame >= Snapshots[Head].Frame)
+		{
+			return;
+		}
+
+		const int32 Discarded = FMath::Min(static_cast<int32>(Snapshots[Head].Frame - Frame), Num);
+		Head = (Head - Discarded + Snapshots.Num()) % Snapshots.Num();
+		Num -= Discarded;
+	}
+
+	int32 GetNum() const { return Num; }
+
+private:
+	TArray<FClimbSnapshot> Snapshots;
+	int32 Head = INDEX_NONE;
+	int32 Num = 0;
+};
+
 /**
  * 
  */
@@ -35,6 +283,12 @@ public:
 	void ToggleClimbingMode(bool bEnableClimb);
 	bool IsClimbing() const;
 
+	// 是否处于样条线攀爬路径模式（梯子、绳索、水管、滑索）
+	bool IsOnClimbPath() const;
+
+	// 是否挂在边缘上
+	bool IsLedgeHanging() const;
+
 	// 是否可以开始攀爬
 	bool CanStartClimbing();
 
@@ -43,6 +297,15 @@ public:
 
 	FORCEINLINE FVector GetCurrentClimbableSurfaceLocation() const { return CurrentClimbableSurfaceLocation; }
 	FORCEINLINE FVector GetCurrentClimbableSurfaceNormal() const { return CurrentClimbableSurfaceNormal; }
+	FORCEINLINE const TArray<FHitResult>& GetClimbableSurfaceTraceHits() const { return ClimbableSurfaceTraceHits; }	// 这一帧拟合表面使用的命中
+	FORCEINLINE const CS_ClimbTrace::FTraceContext& GetClimbTraceContext() const { return ClimbTraceContext; }	// 攀爬检测使用的查询参数
+
+	FORCEINLINE bool IsInCornerTransition() const { return CornerTransition.bActive; }	// 是否处于墙角过渡
+
+	FORCEINLINE AClimbPathActor* GetActiveClimbPath() const { return ActiveClimbPath; }	// 当前攀爬路径
+
+	FORCEINLINE const FClimbDistanceFieldCache& GetClimbDistanceField() const { return ClimbDistanceField; }	// 攀爬距离场缓存
+	FORCEINLINE const FClimbSurfaceProperties& GetCurrentClimbSurface() const { return CurrentClimbSurface; }	// 当前攀爬表面的材质属性
 
 	FVector GetUnRotatedClimbVelocity() const;	// 获取未旋转的攀爬速度
 
@@ -51,9 +314,52 @@ public:
 
 	void ClimbDash();	// 攀爬冲刺
 
+	bool WallJump();	// 蹬墙跳，返回是否跳起
+
+	// 由蒙太奇中的 UAnimNotifyState_ClimbWindow 调用
+	void NotifyClimbWindowBegin(EClimbWindowType WindowType, const UAnimMontage* Montage);
+	void NotifyClimbWindowEnd(EClimbWindowType WindowType);
+
+	bool IsClimbWindowOpen(EClimbWindowType WindowType) const;
+
+	bool IsAcceptingBufferedClimbInput() const;	// 当前蒙太奇是否接受缓存输入
+
+	EClimbTraversalState GetClimbTraversalState() const { return ClimbTraversal.GetState(); }
+
+	const FClimbTraversalStateMachine& GetClimbTraversal() const { return ClimbTraversal; }
+
+	// 这个角色的攀爬内存占用（不包括共享的蒙太奇资源）
+	void GetClimbMemoryUsage(FClimbMemoryUsage& OutUsage) const;
+
+	// 使用的攀爬蒙太奇，多个角色共享，统计时去重
+	void GetClimbMontages(TSet<const UAnimMontage*>& OutMontages) const;
+
+	// 保存和恢复攀爬状态快照（不包括帧号、时间和输入以外的缓冲区信息）
+	void SaveClimbSnapshot(FClimbSnapshot& OutSnapshot) const;
+	void RestoreClimbSnapshot(const FClimbSnapshot& Snapshot);
+
+	// 从修正后的快照开始，用缓冲区中记录的输入重新模拟之后的 NumFrames 帧，返回实际模拟的帧数
+	int32 ResimulateClimb(const FClimbSnapshot& CorrectedSnapshot, int32 NumFrames);
+
+	// 从缓冲区中某一帧的快照开始重新模拟到当前帧
+	int32 ResimulateClimbFromFrame(uint32 Frame);
+
+	const FClimbSnapshotBuffer& GetClimbSnapshots() const { return ClimbSnapshots; }
+
+	uint32 GetClimbSimFrame() const { return ClimbSimFrame; }
+
+	// 上一帧的检测次数（浸泡测试统计使用）
+	uint32 GetLastFrameClimbTraces() const { return LastFrameClimbTraces; }
+
+	// 服务器校验客户端声明的攀爬动作：先查几何缓存，缓存无法判断时才做完整检测
+	bool ValidateClimbMove(const FClimbMoveClaim& Claim);
+
 protected:
 	UFUNCTION()
-	void OnClimbMontageEnded(UAnimMontage* Montage, bool bBInterrupted);		// 攀爬蒙太奇结束
+	void OnClimbMontageBlendingOut(UAnimMontage* Montage, bool bBInterrupted);		// 攀爬蒙太奇淡出
+
+	UFUNCTION(Server, Reliable)
+	void Server_RequestClimbMove(const FClimbMoveClaim& Claim);		// 客户端开始攀爬动作后请求服务器执行
 
 	virtual void BeginPlay() override;
 
@@ -85,25 +391,31 @@ private:
 	// 检查是否应该攀爬
 	bool CheckShouldClimb() const;
 
+	// 法线是否足够陡峭，可以攀爬
+	bool IsClimbableSurfaceNormal(const FVector& SurfaceNormal) const;
+
 	// 检测是否到达地面
 	bool CheckReachableGround() const;
 
 	// 检测是否到达攀爬顶端
-	bool CheckReachedLedge() const;
+	bool CheckReachedLedge(FHitResult& OutLedgeTopHit) const;
 
 	// 跟踪可攀爬表面
 	bool TraceClimbableSurface();
 
-	// 从眼睛高度开始跟踪
-	FHitResult TraceFromEyeHeight(float TraceDistance, float TraceStartOffset = 0.f, bool bShowDebug = false, bool bDrawPersistantShapes = false) const;
-
-	FHitResult TraceFromEyeHeight_V(float TraceDistance, float TraceStartOffset = 0.f, bool bShowDebug = false, bool bDrawPersistantShapes = false) const;
+	// 从眼睛高度开始跟踪（AxisPolicy 为眼睛高度的偏移方向，需要调试绘制时传入 CS_ClimbTrace::FDebugForDuration 等调试策略）
+	template <typename AxisPolicy = CS_ClimbTrace::FUpAxis, typename DebugPolicy = CS_ClimbTrace::FNoDebug>
+	FHitResult TraceFromEyeHeight(float TraceDistance, float TraceStartOffset = 0.f) const;
 
 	// 胶囊体射线检测
-	TArray<FHitResult> DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, bool bShowDebug, bool bDrawPersistantShapes = false) const;
+	template <typename DebugPolicy = CS_ClimbTrace::FNoDebug>
+	TArray<FHitResult> DoCapsuleTraceMultiByObject(const FVector& Start, const FVector& End, bool bReturnPhysicalMaterial = false) const;
 
 	// 线性射线检测 (单个，用于检测是否达到攀爬顶端）
-	FHitResult DoLineTraceSingleByObject(const FVector& Start, const FVector& End, bool bShowDebug, bool bDrawPersistantShapes = false) const;
+	template <typename DebugPolicy = CS_ClimbTrace::FNoDebug>
+	FHitResult DoLineTraceSingleByObject(const FVector& Start, const FVector& End) const;
+
+	CS_ClimbTrace::FTraceContext ClimbTraceContext;	// 在 BeginPlay 中构建的检测参数
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
 	float ClimbCapsuleTraceRadius = 50.0f;		// 胶囊体射线检测半径
@@ -114,6 +426,9 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
 	TArray<TEnumAsByte<EObjectTypeQuery>> ClimbTraceObjectTypes;	// 胶囊体射线检测对象类型
 
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
+	bool bUseClimbTraceChannel = false;	// 使用攀爬检测通道，只命中攀爬碰撞代理（ClimbProxy），忽略 ClimbTraceObjectTypes
+
 	TArray<FHitResult> ClimbableSurfaceTraceHits;	// 可攀爬表面的射线检测结果
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
@@ -135,6 +450,16 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
 	float CharacterCapsuleHalfHeight = 94.f;	// 角色胶囊体高度
 
+	/**
+	 * Climb Capsule （进出攀爬时的胶囊体变形）
+	 * 形状、位置和旋转在同一个移动作用域内提交；变大之前用一次扫描找到不穿透的位置，被阻挡时保持小胶囊体并在之后每帧重试
+	 */
+	void ShrinkClimbCapsule();		// 进入攀爬：缩小胶囊体
+	bool TryRestoreClimbCapsule();	// 离开攀爬：恢复胶囊体并摆正旋转，返回是否恢复了高度
+	bool FindClimbCapsuleRestoreLocation(float TargetHalfHeight, const FQuat& TargetRotation, FVector& OutLocation) const;	// 一次扫描找到恢复后的位置
+
+	bool bPendingClimbCapsuleRestore = false;	// 上一次恢复被阻挡
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
 	float ClimbToTopTraceDistance = 10.f;	// 攀爬到顶端射线检测距离
 
@@ -149,6 +474,72 @@ private:
 	FVector CurrentClimbableSurfaceLocation;	// 当前可攀爬表面的位置
 	FVector CurrentClimbableSurfaceNormal;		// 当前可攀爬表面的法线
 
+	FVector LastValidClimbableSurfaceLocation = FVector::ZeroVector;	// 最近一次有效的攀爬表面位置（表面丢失时用于墙角检测）
+	FVector LastValidClimbableSurfaceNormal = FVector::ZeroVector;		// 最近一次有效的攀爬表面法线
+
+	float ClimbableSurfaceNormalSpread = 1.f;	// 各个命中法线与平均法线点积的最小值，越小说明命中分布在越多个面上
+
+	/**
+	 * Climb Surface Materials （攀爬表面属性由命中的物理材质决定）
+	 * 只有攀爬表面检测请求物理材质，解析结果按材质缓存
+	 */
+	bool ResolveClimbSurfaceProperties();	// 剔除不可攀爬的命中并合并剩余命中的属性，返回是否还有可攀爬的命中
+	bool UpdateClimbGrip(float DeltaTime);	// 累计在当前表面上的抓握时间，返回是否脱手
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Surface Materials", meta=(AllowPrivateAccess = "true"))
+	bool bUseClimbSurfaceMaterials = true;	// 按物理材质决定攀爬属性（关闭后检测不再请求物理材质，所有表面使用 DefaultClimbSurface）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Surface Materials", meta=(AllowPrivateAccess = "true"))
+	FClimbSurfaceProperties DefaultClimbSurface;	// 没有配置攀爬属性的材质使用的属性
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Surface Materials", meta=(AllowPrivateAccess = "true"))
+	TMap<UPhysicalMaterial*, FClimbSurfaceProperties> ClimbSurfaceMaterialOverrides;	// 普通物理材质的攀爬属性（UClimbPhysicalMaterial 使用自己的属性）
+
+	FClimbSurfaceMaterialCache ClimbSurfaceMaterials;
+	FClimbSurfaceProperties CurrentClimbSurface;	// 当前攀爬表面的属性
+	float ClimbGripTime = 0.f;						// 在需要抓握的表面上已经攀爬的时间
+
+	/**
+	 * Climb Surface Base （攀爬表面基座：在命中组件的本地坐标系中记录攀爬表面）
+	 * 基座的运动由角色的基座移动（和行走时一样）处理，只有角色相对基座移动时才重新检测表面
+	 */
+	bool ShouldReprobeClimbSurface() const;		// 是否需要重新检测攀爬表面
+
+	void UpdateClimbSurfaceBase();				// 根据检测结果更新基座和本地表面缓存
+
+	void RefreshClimbSurfaceFromBase();			// 用基座当前的变换还原世界空间的表面
+
+	void InvalidateClimbSurfaceBase();			// 清除本地表面缓存
+
+	bool GetClimbSurfaceBaseTransform(FTransform& OutTransform) const;	// 基座的变换（基座是骨骼网格时为基座骨骼的变换）
+
+	FVector ClimbSurfaceLocalLocation = FVector::ZeroVector;	// 基座本地坐标系下的表面位置
+	FVector ClimbSurfaceLocalNormal = FVector::ZeroVector;		// 基座本地坐标系下的表面法线
+	FVector LastProbeBaseLocalLocation = FVector::ZeroVector;	// 上一次检测时角色在基座本地坐标系下的位置
+	float LastClimbSurfaceProbeTime = 0.f;						// 上一次检测的时间
+	bool bHasClimbSurfaceBaseCache = false;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Base", meta=(AllowPrivateAccess = "true"))
+	float ClimbSurfaceReprobeDistance = 2.f;	// 角色相对基座移动超过该距离时重新检测
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Base", meta=(AllowPrivateAccess = "true"))
+	float ClimbSurfaceMaxCacheTime = 0.5f;		// 缓存的最长有效时间，超过后强制检测一次
+
+	/**
+	 * Skeletal Climb Surfaces （在动画骨骼网格上攀爬：以命中的骨骼为基座，表面记录在骨骼坐标系中）
+	 * 攀爬时只扫描上一次命中的物理体和它在物理资产中的父、子物理体，不扫描整个骨骼网格和场景
+	 * 这些物理体都没有命中时才回退到场景扫描，由场景扫描找到新的骨骼
+	 */
+	bool TraceClimbableBoneBodies(const FVector& Start, const FVector& End);	// 按骨骼扫描攀爬表面，返回是否命中
+	void UpdateClimbBoneBodies(const USkeletalMeshComponent* SkeletalMesh, FName BoneName);	// 基座骨骼改变时重新收集要扫描的物理体
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Skeletal", meta=(AllowPrivateAccess = "true"))
+	bool bTrackClimbSurfaceBones = true;	// 在骨骼网格上攀爬时以骨骼为基座并按物理体扫描
+
+	TWeakObjectPtr<const USkeletalMeshComponent> ClimbBoneMesh;	// 收集物理体时的骨骼网格
+	FName ClimbBoneName;										// 收集物理体时的基座骨骼
+	TArray<int32, TInlineAllocator<8>> ClimbBoneBodies;			// 要扫描的物理体在 Bodies 中的下标
+
 	UPROPERTY()
 	UAnimInstance* CharacterAnimInstance;
 
@@ -171,36 +562,360 @@ private:
 
 	void TryStartVaulting();	// 尝试开始翻越
 
-	bool CanStartVaulting(FVector& OutVaultStartLocation, FVector& OutVaultLandLocation) const;	// 是否可以开始翻越，返回翻越起始位置和落地位置
+	bool CanStartVaulting(FVector& OutVaultStartLocation, FVector& OutVaultLandLocation, FHitResult* OutVaultStartHit = nullptr, FHitResult* OutVaultLandHit = nullptr) const;	// 是否可以开始翻越，返回翻越起始位置和落地位置
 
 	void SetMotionWarpingTarget(const FName& TargetSectionName, const FVector& TargetLocation) const;	// 设置翻越运动扭曲目标
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
 	UAnimMontage* AnimMontage_Vaulting;
 
-	void HandleClimbDashUp();	// 处理攀爬冲刺上
+	/**
+	 * Climb Dash （全方向攀爬冲刺：所有方向的可达性由一次批量查询得到）
+	 */
+	void BuildClimbDashDirections();	// 从数据表加载冲刺方向，没有数据表时用四个冲刺蒙太奇生成默认的8方向
+
+	// 一次批量查询：收集所有方向检测线段范围内的组件，再逐方向只对这些组件做窄相检测
+	void QueryClimbDashCandidates(TArray<FClimbDashCandidate>& OutCandidates) const;
+
+	int32 SelectClimbDashDirection(const FVector2D& UnRotatedInput, const TArray<FClimbDashCandidate>& Candidates) const;	// 根据输入选择最接近的可达方向
+
+	bool IsClimbDashMontage(const UAnimMontage* Montage) const;	// 是否是冲刺蒙太奇
+
+	// 一次宽相查询，收集包围盒内的可攀爬组件，后续只对这些组件做窄相检测
+	void GatherClimbQueryComponents(const FBox& QueryBounds, const FCollisionQueryParams& QueryParams, TArray<UPrimitiveComponent*>& OutComponents) const;
+
+	void BakeClimbDashTrajectories();	// 预先采样每个冲刺蒙太奇的根动作轨迹
+
+	// 沿运动扭曲后的根动作轨迹做胶囊体扫描，轨迹被挡住时拒绝冲刺
+	bool ValidateClimbDashTrajectory(const FClimbDashDirection& DashDirection, const FVector& TargetPoint) const;
+
+	TMap<const UAnimMontage*, FClimbDashTrajectory> ClimbDashTrajectories;	// 每个冲刺蒙太奇的根动作轨迹
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Dash", meta=(AllowPrivateAccess = "true"))
+	int32 ClimbDashTrajectorySamples = 8;	// 每条轨迹的采样段数
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Dash", meta=(AllowPrivateAccess = "true"))
+	float ClimbDashSweepShrink = 5.f;	// 轨迹扫描时胶囊体缩小的距离，避免擦边的误判
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Dash", meta=(AllowPrivateAccess = "true", RequiredAssetDataTags = "RowStructure=/Script/ClimbingSystem.ClimbDashDirection"))
+	UDataTable* ClimbDashDirectionTable;	// 冲刺方向数据表（行结构为FClimbDashDirection）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Dash", meta=(AllowPrivateAccess = "true"))
+	float ClimbDashMinInputAlignment = 0.7f;	// 输入方向和冲刺方向点积的最小值
 
-	bool CheckClimbDashUp(FVector& OutTargetPoint);	// 检查攀爬冲刺上
+	UPROPERTY(Transient)
+	TArray<FClimbDashDirection> ClimbDashDirections;	// 运行时使用的冲刺方向
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
 	UAnimMontage* AnimMontage_ClimbDashUp;
 
-	void HandleClimbDashDown();	// 处理攀爬冲刺下
-	bool CheckClimbDashDown(FVector& OutTargetPoint);	// 检查攀爬冲刺下
-
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
 	UAnimMontage* AnimMontage_ClimbDashDown;
 
-	void HandleClimbDashLeft();	// 处理攀爬冲刺左
-	bool CheckClimbDashLeft(FVector& OutTargetPoint);	// 检查攀爬冲刺左
-
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
 	UAnimMontage* AnimMontage_ClimbDashLeft;
 
-	void HandleClimbDashRight();	// 处理攀爬冲刺右
-	bool CheckClimbDashRight(FVector& OutTargetPoint);	// 检查攀爬冲刺右
-
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing", meta=(AllowPrivateAccess = "true"))
 	UAnimMontage* AnimMontage_ClimbDashRight;
 
+	/**
+	 * Corner Wrapping （内/外墙角包裹）
+	 */
+	bool ShouldProbeCorner() const;		// 是否需要检测墙角（只在横向移动且表面信息退化时检测）
+
+	bool TryStartCornerTransition();	// 尝试开始墙角过渡
+
+	// 一次性查询相邻墙面：先沿移动方向检测内墙角，再从墙后往回检测外墙角
+	bool ProbeAdjacentCornerFace(const FVector& MoveDirection, EClimbCornerType& OutCornerType, FHitResult& OutAdjacentHit) const;
+
+	// 根据两个墙面解析计算墙角过渡路径
+	bool ComputeCornerTransition(EClimbCornerType CornerType, const FVector& AdjacentLocation, const FVector& AdjacentNormal);
+
+	void PhysClimbCornerTransition(float DeltaTime);	// 沿解析路径移动角色
+
+	void EndCornerTransition(bool bReachedTarget);		// 结束墙角过渡
+
+	FClimbCornerTransition CornerTransition;
+
+	FVector LastFailedCornerProbeLocation = FVector::ZeroVector;	// 上一次墙角检测失败的位置
+	bool bHasFailedCornerProbe = false;							// 在离开失败位置一定距离前不重复检测，避免边缘处的检测风暴
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Corner", meta=(AllowPrivateAccess = "true"))
+	bool bEnableCornerWrapping = true;	// 是否开启墙角包裹
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Corner", meta=(AllowPrivateAccess = "true"))
+	float CornerNormalSpreadAngle = 30.f;	// 命中法线分散超过该角度时认为到达墙角
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Corner", meta=(AllowPrivateAccess = "true"))
+	float CornerProbeDistance = 80.f;	// 相邻墙面检测距离
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Corner", meta=(AllowPrivateAccess = "true"))
+	float CornerExitDistance = 40.f;	// 过渡结束后角色距离墙角棱线的距离
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Corner", meta=(AllowPrivateAccess = "true"))
+	float CornerProbeRetryDistance = 30.f;	// 检测失败后需要移动多远才再次检测
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Corner", meta=(AllowPrivateAccess = "true", ClampMin = "0.01"))
+	float MinCornerTransitionTime = 0.2f;	// 墙角过渡最短时长
+
+	/**
+	 * Climb Path （样条线攀爬路径：梯子、绳索、水管、滑索）
+	 */
+	bool TryStartClimbPath();		// 尝试抓住附近的攀爬路径（只查询已有的重叠结果，进入时做一次位置校验）
+
+	void StopClimbPath();			// 离开攀爬路径
+
+	void PhysClimbPath(float DeltaTime, int32 Iterations);	// 沿样条线移动，不做任何表面检测
+
+	bool TryExitClimbPathAtEnd(bool bAtEnd);	// 到达路径端点时尝试离开，离开位置做一次校验
+
+	bool IsCapsuleLocationFree(const FVector& TestLocation) const;	// 校验角色胶囊体在该位置是否会卡住
+
+	static ECustomMovementMode::Type GetMovementModeForClimbPath(const AClimbPathActor* ClimbPath);	// 路径类型对应的移动模式
+
+	UPROPERTY()
+	AClimbPathActor* ActiveClimbPath;	// 当前攀爬路径
+
+	float ClimbPathDistance = 0.f;		// 当前在路径上的距离
+	float ClimbPathSpeed = 0.f;			// 当前沿路径的速度（带符号）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Path", meta=(AllowPrivateAccess = "true"))
+	float ClimbPathAcceleration = 600.f;	// 沿路径的加速度
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Path", meta=(AllowPrivateAccess = "true"))
+	float ClimbPathBrakingDeceleration = 800.f;	// 没有输入时的减速度
+
+	/**
+	 * Landscape Fast Path （地形快速路径：直接采样碰撞高度场，代替物理扫描）
+	 */
+	bool CanUseLandscapeFastPath() const;		// 上一次完整扫描只命中了地形，且没有超过强制扫描间隔
+
+	void UpdateClimbLandscapeFromHits();		// 根据完整扫描的结果判断是否可以使用地形快速路径
+
+	bool TraceClimbableLandscape();				// 地形上的攀爬表面检测
+
+	bool CheckReachableLandscapeGround() const;	// 地形上的到达地面检测
+
+	bool CheckReachedLandscapeLedge(FHitResult& OutLedgeTopHit) const;	// 地形上的到达顶端检测
+
+	TWeakObjectPtr<ALandscapeProxy> ClimbLandscape;					// 当前攀爬的地形
+	TWeakObjectPtr<UPrimitiveComponent> ClimbLandscapeComponent;		// 上一次命中的地形碰撞组件
+	float LastFullClimbSweepTime = 0.f;								// 上一次完整物理扫描的时间
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Landscape", meta=(AllowPrivateAccess = "true"))
+	bool bEnableLandscapeFastPath = true;	// 是否开启地形快速路径
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Landscape", meta=(AllowPrivateAccess = "true"))
+	float LandscapeFullSweepInterval = 0.25f;	// 强制完整扫描的间隔，用于发现地形上的非地形物体
+
+	/**
+	 * Distance Field Cache （角色周围的稀疏距离场缓存，用三线性查询代替物理检测）
+	 */
+	void UpdateClimbDistanceField();		// 请求/淘汰砖块并在预算内构建
+
+	bool TraceClimbableDistanceField();		// 距离场上的攀爬表面检测
+
+	bool TraceWithClimbDistanceField(const FVector& Start, const FVector& End, FHitResult& OutHit) const;	// 距离场可用时用距离场做线性检测
+
+	FClimbDistanceFieldCache ClimbDistanceField;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Distance Field", meta=(AllowPrivateAccess = "true"))
+	bool bUseClimbDistanceField = false;	// 是否使用距离场缓存（砖块不可用时自动回退到物理检测）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Distance Field", meta=(AllowPrivateAccess = "true"))
+	float ClimbDistanceFieldVoxelSize = 20.f;	// 体素大小
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Distance Field", meta=(AllowPrivateAccess = "true"))
+	int32 ClimbDistanceFieldBrickResolution = 4;	// 每个砖块每个轴的体素数
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Distance Field", meta=(AllowPrivateAccess = "true"))
+	float ClimbDistanceFieldRadius = 250.f;		// 角色周围缓存的半径（需要覆盖冲刺检测的距离）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Distance Field", meta=(AllowPrivateAccess = "true"))
+	int32 ClimbDistanceFieldBricksPerFrame = 8;		// 每帧最多请求的新砖块数
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Distance Field", meta=(AllowPrivateAccess = "true"))
+	int32 ClimbDistanceFieldSamplesPerFrame = 1024;	// 每帧最多计算的体素采样数
+
+	/**
+	 * Wall Jump （蹬墙跳：解析计算抛物线，一次批量扫描找到落点，空中直接使用求解结果重新抓墙）
+	 */
+	// 沿给定初速度的抛物线做批量扫描，找到第一个可攀爬的落点
+	bool SolveWallJumpTrajectory(const FVector& LaunchLocation, const FVector& LaunchVelocity, const TArray<UPrimitiveComponent*>& CandidateComponents, FClimbJumpTarget& OutTarget) const;
+
+	FVector GetWallJumpVelocity(const FVector& HorizontalDirection, float PitchDegrees) const;	// 计算起跳速度
+
+	void TickWallJumpRegrab();	// 下落时到达求解的时间点后重新抓墙
+
+	FClimbJumpTarget WallJumpTarget;	// 当前求解出的落点
+	float WallJumpStartTime = 0.f;		// 起跳时间
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Wall Jump", meta=(AllowPrivateAccess = "true"))
+	float WallJumpSpeed = 800.f;	// 起跳速度
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Wall Jump", meta=(AllowPrivateAccess = "true"))
+	TArray<float> WallJumpPitchAngles = { 20.f, 35.f, 50.f };	// 依次尝试的起跳仰角，第一个找到落点的角度生效，都找不到时使用中间的角度
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Wall Jump", meta=(AllowPrivateAccess = "true"))
+	float WallJumpMaxFlightTime = 1.2f;	// 求解的最长飞行时间
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Wall Jump", meta=(AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 WallJumpTrajectorySegments = 12;	// 抛物线分段数
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Wall Jump", meta=(AllowPrivateAccess = "true"))
+	float WallJumpRegrabLeadTime = 0.05f;	// 提前多少秒抓墙
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Wall Jump", meta=(AllowPrivateAccess = "true"))
+	float WallJumpRegrabTolerance = 50.f;	// 抓墙时角色离求解位置的最大偏差，超过说明轨迹被干扰
+
+	/**
+	 * Ledge Hang （挂边和横移：抓住时提取一次边缘线段，之后沿线段解析移动，只在端点检测下一段边缘）
+	 */
+	bool TryStartLedgeHang(const FHitResult& LedgeTopHit);	// 到达顶端时尝试挂边
+
+	// 根据墙面和顶面提取边缘线段，线段范围由顶面组件的包围盒裁剪得到，不需要检测
+	bool ExtractLedgeSegment(const FVector& WallPoint, const FVector& WallNormal, const FHitResult& LedgeTopHit, FClimbLedgeSegment& OutSegment) const;
+
+	void PhysLedgeHang(float DeltaTime, int32 Iterations);	// 沿边缘线段横移
+
+	bool TryChainLedgeSegment(float Direction);		// 到达线段端点时检测相邻的边缘
+
+	FVector GetLedgeHangLocation(float Distance) const;	// 线段上某一距离处挂边时胶囊体中心的位置
+
+	/**
+	 * Top-out Prediction （用攀爬速度外推蒙太奇提前时间后的位置，提前检测顶端，结果缓存到角色偏离为止）
+	 */
+	bool CheckPredictedLedge(FHitResult& OutLedgeTopHit);	// 不需要每帧检测的顶端判断
+
+	void UpdateTopOutPrediction();		// 从眼睛上方向下检测一次，找到前方的顶端
+
+	bool IsTopOutPredictionValid() const;	// 角色是否仍在预测的范围内
+
+	float GetTopOutLeadTime() const;	// 蒙太奇需要提前开始的时间
+
+	FClimbTopOutPrediction TopOutPrediction;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|TopOut", meta=(AllowPrivateAccess = "true"))
+	bool bEnableTopOutPrediction = true;	// 是否使用预测的顶端检测
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|TopOut", meta=(AllowPrivateAccess = "true"))
+	float TopOutLeadTime = 0.f;	// 提前开始的时间，为0时使用上墙蒙太奇的混合时间
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|TopOut", meta=(AllowPrivateAccess = "true"))
+	float TopOutLookaheadDistance = 150.f;	// 眼睛上方检测顶端的范围
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|TopOut", meta=(AllowPrivateAccess = "true"))
+	float TopOutDeviationTolerance = 20.f;	// 横向偏离预测位置超过这个距离时重新预测
+
+	FClimbLedgeSegment LedgeSegment;		// 当前边缘线段
+	float LedgeHangDistance = 0.f;			// 当前在线段上的位置
+	float FailedLedgeChainDirection = 0.f;	// 上一次在端点检测失败的方向，反向移动前不再检测
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Ledge", meta=(AllowPrivateAccess = "true"))
+	bool bEnableLedgeHang = true;	// 到达顶端时是否先挂边（向上输入时再爬上去）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Ledge", meta=(AllowPrivateAccess = "true"))
+	float LedgeShimmySpeed = 120.f;	// 横移速度
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Ledge", meta=(AllowPrivateAccess = "true"))
+	float LedgeHangWallOffset = 45.f;	// 挂边时胶囊体中心离墙面的距离
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Ledge", meta=(AllowPrivateAccess = "true"))
+	float LedgeHangVerticalOffset = 100.f;	// 挂边时胶囊体中心在边缘下方的距离
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Ledge", meta=(AllowPrivateAccess = "true"))
+	float MaxLedgeSegmentHalfLength = 500.f;	// 没有组件包围盒时线段的最大半长
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Ledge", meta=(AllowPrivateAccess = "true"))
+	float LedgeChainProbeDistance = 30.f;	// 端点外检测相邻边缘的距离
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Ledge", meta=(AllowPrivateAccess = "true"))
+	float LedgeChainHeightTolerance = 30.f;	// 相邻边缘允许的高度差
+
+	/**
+	 * Climb Windows （蒙太奇中的通知窗口：在标记的帧切换移动模式，窗口内缓存输入，并允许打断）
+	 */
+	void ApplyClimbMontageTransition(const UAnimMontage* Montage);	// 蒙太奇对应的移动模式切换，每次播放只执行一次
+
+	bool IsClimbMontageLocked() const;	// 当前蒙太奇是否阻止新的攀爬动作
+
+	bool BufferClimbAction(EClimbBufferedAction Action);	// 蒙太奇阻止时缓存输入，返回是否被缓存
+
+	void ConsumeBufferedClimbAction();	// 执行未过期的缓存输入
+
+	uint8 OpenClimbWindows = 0;		// 当前打开的窗口（按 EClimbWindowType 的位）
+
+	const UAnimMontage* ClimbTransitionAppliedMontage = nullptr;	// 已经在切换窗口中完成切换的蒙太奇
+
+	EClimbBufferedAction BufferedClimbAction = EClimbBufferedAction::None;
+	float BufferedClimbActionTime = 0.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Windows", meta=(AllowPrivateAccess = "true"))
+	float ClimbInputBufferTime = 0.4f;	// 缓存输入的有效时间
+
+	/**
+	 * Traversal State Machine （每个状态只运行自己声明的检测，切换受状态描述约束）
+	 */
+	EClimbTraversalState ResolveClimbTraversalState() const;	// 根据移动模式和当前蒙太奇得到的状态
+
+	EClimbTraversalState GetTraversalStateForMontage(const UAnimMontage* Montage) const;	// 蒙太奇对应的状态，不是攀爬蒙太奇时返回MAX
+
+	FClimbTraversalStateMachine ClimbTraversal;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Traversal", meta=(AllowPrivateAccess = "true", RequiredAssetDataTags = "RowStructure=/Script/ClimbingSystem.ClimbTraversalStateRow"))
+	UDataTable* ClimbTraversalStateTable;	// 状态描述数据表（行结构为FClimbTraversalStateRow），缺少的状态使用默认描述
+
+	/**
+	 * Snapshots （每帧记录攀爬快照到环形缓冲区，用于回滚修正和重新模拟）
+	 */
+	void RecordClimbSnapshot(float DeltaTime);
+
+	FClimbSnapshotBuffer ClimbSnapshots;
+	uint32 ClimbSimFrame = 0;			// 记录快照的模拟帧号
+	bool bRestoringClimbSnapshot = false;	// 恢复快照期间忽略蒙太奇淡出事件
+	bool bResimulatingClimb = false;		// 重新模拟期间不记录新的帧号
+
+	mutable TArray<FName, TInlineAllocator<FClimbSnapshot::MaxWarpTargets>> ClimbWarpTargetNames;	// 设置过的运动扭曲目标
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Snapshots", meta=(AllowPrivateAccess = "true"))
+	bool bRecordClimbSnapshots = false;	// 是否每帧记录快照（竞技模式下开启）
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Snapshots", meta=(AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 ClimbSnapshotBufferSize = 64;	// 环形缓冲区的帧数
+
+	/**
+	 * Move Validation （服务器校验客户端的上墙、冲刺和翻越）
+	 */
+	bool ShouldValidateClimbMoves() const;		// 本地是否由服务器校验（自主代理）
+	bool IsAwaitingClimbMoveClaims() const;		// 服务器上远程控制的角色，等待客户端声明而不自己检测
+	FClimbMoveClaim MakeStartClimbClaim() const;	// 用上墙检测的第一个命中生成声明
+	void SendClimbMoveClaim(const FClimbMoveClaim& Claim);
+	bool ValidateClimbMoveWithTraces(const FClimbMoveClaim& Claim, FHitResult& OutSurfaceHit, FHitResult& OutTargetHit);
+	bool ValidateClimbMoveTarget(const FClimbMoveClaim& Claim) const;		// 动作本身的检测，缓存命中时也要执行
+	bool TraceClaimedSurfacePoint(const UPrimitiveComponent* Component, const FVector& Point, const FVector& Normal, FHitResult& OutHit) const;
+	void ExecuteClimbMove(const FClimbMoveClaim& Claim);
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Validation", meta=(AllowPrivateAccess = "true"))
+	bool bValidateClimbMoves = true;		// 联网时由服务器校验客户端的攀爬动作
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Validation", meta=(AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbValidationTolerance = 15.f;	// 声明点和已验证采样 / 检测结果之间允许的距离
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Validation", meta=(AllowPrivateAccess = "true", ClampMin = "-1.0", ClampMax = "1.0"))
+	float ClimbValidationNormalDot = 0.9f;	// 声明法线和检测法线的最小点积
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Character Movement: Climbing|Validation", meta=(AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ClimbValidationReach = 600.f;		// 声明点离服务器角色位置的最大距离（包括冲刺和翻越的距离）
+
+	double LastClimbMoveRejectLogTime = -UE_BIG_NUMBER;	// 拒绝日志限流：上一次输出的时间
+	int32 NumSuppressedClimbMoveRejectLogs = 0;			// 拒绝日志限流：之后被省略的次数
+
+	/**
+	 * Telemetry （climb.Telemetry 开启时记录攀爬事件和每帧检测耗时）
+	 */
+	void RecordClimbTelemetry(EClimbTelemetryEvent Event) const;
+
+	uint32 LastFrameClimbTraces = 0;
+	uint64 ClimbWorkCycles = 0;		// 这一帧攀爬物理和检测的耗时（不包括基类的移动和遥测本身）
+
 };
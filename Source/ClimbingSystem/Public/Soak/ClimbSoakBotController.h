@@ -0,0 +1,65 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Controller.h"
+#include "ClimbSoakBotController.generated.h"
+
+class AClimbingSystemCharacter;
+
+// 机器人当前的行为
+UENUM()
+enum class EClimbSoakBotAction : uint8
+{
+	Wander,		// 在地面上朝随机方向走，途中尝试上墙和翻越
+	Climb,		// 攀爬：向上爬，随机横移、冲刺和蹬墙跳
+	Hang		// 挂在边缘：横移或者爬上去
+};
+
+/**
+ * 浸泡测试机器人，直接向攀爬移动组件发送输入，不需要玩家输入映射
+ * 所有随机行为来自种子化的随机流，同样的种子和地图得到同样的输入序列
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API AClimbSoakBotController : public AController
+{
+	GENERATED_BODY()
+
+public:
+	AClimbSoakBotController();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	void InitializeBot(int32 Seed);
+
+	int32 GetNumActions() const { return NumActions; }
+
+protected:
+	virtual void OnPossess(APawn* InPawn) override;
+
+private:
+	void TickWander(AClimbingSystemCharacter* Character, float DeltaSeconds);
+	void TickClimb(AClimbingSystemCharacter* Character, float DeltaSeconds);
+	void TickHang(AClimbingSystemCharacter* Character, float DeltaSeconds);
+	void PickWanderDirection();
+
+	FRandomStream RandomStream;
+	EClimbSoakBotAction Action = EClimbSoakBotAction::Wander;
+
+	FVector WanderDirection = FVector::ForwardVector;
+	FVector2D ClimbInput = FVector2D(0.f, 1.f);		// 攀爬平面上的输入（X 右，Y 上）
+	float ActionTimeRemaining = 0.f;	// 当前方向 / 输入的剩余时间
+	float NextClimbAttemptTime = 0.f;	// 下一次主动尝试上墙的时间
+	float StuckTime = 0.f;				// 地面上几乎没有移动的时间
+	int32 NumActions = 0;				// 触发的上墙、冲刺、蹬墙跳次数
+
+	UPROPERTY(EditDefaultsOnly, Category = "Soak")
+	float DashChancePerSecond = 0.5f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Soak")
+	float WallJumpChancePerSecond = 0.15f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Soak")
+	float ClimbAttemptInterval = 0.75f;
+};
@@ -0,0 +1,76 @@
+// Copyright INVI_1998, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ClimbSoakTestSubsystem.generated.h"
+
+class AClimbSoakBotController;
+
+// 浸泡测试参数，全部来自命令行
+struct FClimbSoakSettings
+{
+	float Duration = 300.f;			// -ClimbSoak=<秒>
+	int32 NumBots = 32;				// -ClimbSoakBots=
+	int32 Seed = 1;					// -ClimbSoakSeed=
+	float SpawnRadius = 1500.f;		// -ClimbSoakRadius=
+	float HitchMilliseconds = 60.f;	// -ClimbSoakHitchMs=
+	float MaxMemoryGrowthMB = 0.f;	// -ClimbSoakMaxGrowthMB=，大于0时超过则以失败退出
+	bool bExitWhenDone = true;		// -ClimbSoakNoExit 时结束后不退出
+};
+
+/**
+ * 无界面浸泡测试：在测试地图上生成大量机器人持续攀爬、冲刺、翻越和爬到顶端，运行数分钟
+ * 运行中捕获 CSV Profiler 数据，结束时输出帧时间百分位、游戏线程和其他线程的时间、卡顿、内存增长和检测次数
+ *
+ * 用法（Linux）：
+ *   UnrealEditor ClimbingSystem.uproject /Game/ThirdPerson/Maps/ThirdPersonMap -game -nullrhi -unattended -nosound
+ *       -ClimbSoak=600 -ClimbSoakBots=48 -ClimbSoakSeed=7 -ClimbTelemetry
+ */
+UCLASS()
+class CLIMBINGSYSTEM_API UClimbSoakTestSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override { return bRunning; }
+
+private:
+	static bool ParseSettings(FClimbSoakSettings& OutSettings);
+
+	void SpawnBots(UWorld& InWorld);
+	void SampleFrame();
+	void FinishSoak();
+	FString BuildSummary() const;
+
+	FClimbSoakSettings Settings;
+	bool bRunning = false;
+	double StartTime = 0.0;
+	double NextMemorySampleTime = 0.0;
+
+	UPROPERTY()
+	TArray<AClimbSoakBotController*> Bots;
+
+	// 逐帧采样（毫秒）
+	TArray<float> FrameTimes;
+	TArray<float> GameThreadTimes;
+	TArray<float> RenderThreadTimes;
+
+	int32 NumHitches = 0;
+	float WorstHitchMilliseconds = 0.f;
+	uint64 TotalTraces = 0;
+	uint32 PeakTracesPerFrame = 0;
+	uint64 ClimbingBotFrames = 0;	// 处于攀爬、路径或挂边状态的机器人帧数
+
+	uint64 StartUsedMemory = 0;
+	uint64 PeakUsedMemory = 0;
+	uint64 EndUsedMemory = 0;
+	TArray<TPair<float, uint64>> MemorySamples;	// 每秒一次的 (时间, 已用物理内存)
+};